@@ -0,0 +1,77 @@
+'use strict';
+// Compares cost of transient failures inside a large transaction:
+// retry of the failed nested transaction vs retry of the whole outer one.
+// Usage: node bench/nested_transactions.js [puts] [failures]
+const os = require('os');
+const path = require('path');
+const MDBX = require('../lib/binding');
+
+const puts = Number(process.argv[2]) || 100000;
+const failures = Number(process.argv[3]) || 10;
+const dbPath = path.join(os.tmpdir(), 'node_mdbx_bench_nested');
+
+// Each of these steps fails once.
+function createFailures() {
+    const result = new Set();
+    for (let i = 1; i <= failures; i++)
+        result.add(Math.floor(puts * i / (failures + 1)));
+    return result;
+}
+
+function step(dbi, i, pendingFailures) {
+    dbi.put('key' + i, 'value' + i);
+    if (pendingFailures.delete(i))
+        throw new Error('Transient failure.');
+}
+
+function retryNested(db) {
+    const pendingFailures = createFailures();
+    let attempts = 0;
+    db.transact(txn => {
+        const dbi = txn.getDbi();
+        for (let i = 0; i < puts; i++) {
+            for (;;) {
+                attempts++;
+                try {
+                    db.transact(() => step(dbi, i, pendingFailures));
+                    break;
+                } catch(error) {};
+            };
+        };
+    });
+    return attempts;
+}
+
+function retryOuter(db) {
+    const pendingFailures = createFailures();
+    let attempts = 0;
+    for (;;) {
+        try {
+            db.transact(txn => {
+                const dbi = txn.getDbi();
+                for (let i = 0; i < puts; i++) {
+                    attempts++;
+                    step(dbi, i, pendingFailures);
+                };
+            });
+            return attempts;
+        } catch(error) {};
+    };
+}
+
+function run(name, action) {
+    MDBX.clearDb(dbPath);
+    const db = new MDBX({ path: dbPath, syncMode: 'safeNoSync' });
+    try {
+        const start = process.hrtime.bigint();
+        const attempts = action(db);
+        const ms = Number(process.hrtime.bigint() - start) / 1e6;
+        console.log(`${name}: ${ms.toFixed(1)} ms, ${attempts} step attempts`);
+    } finally {
+        db.close();
+    };
+}
+
+console.log(`${puts} puts, ${failures} transient failures`);
+run('retry nested transaction', retryNested);
+run('retry outer transaction', retryOuter);
@@ -0,0 +1,50 @@
+'use strict';
+// Compares commit throughput and memory usage with and without writeMap option.
+// Usage: node bench/writemap.js [totalWrites] [valueSize] [on|off|both]
+// RSS includes touched mapped pages and is never returned, so run each mode in its own process for precise numbers.
+const os = require('os');
+const path = require('path');
+const crypto = require('crypto');
+const MDBX = require('../lib/binding');
+
+const totalWrites = Number(process.argv[2]) || 1000000;
+const valueSize = Number(process.argv[3]) || 100;
+const mode = process.argv[4] || 'both';
+const writesPerTxn = [10000, 100000];
+const dbPath = path.join(os.tmpdir(), 'node_mdbx_bench_writemap');
+
+function run(writeMap, txnWrites) {
+    MDBX.clearDb(dbPath);
+    const db = new MDBX({ path: dbPath, writeMap, syncMode: 'safeNoSync' });
+    const value = crypto.randomBytes(valueSize);
+    let peakRss = process.memoryUsage().rss;
+    try {
+        const start = process.hrtime.bigint();
+        for (let done = 0; done < totalWrites; done += txnWrites) {
+            db.transact(txn => {
+                const dbi = txn.getDbi();
+                // Random keys dirty pages all over the tree.
+                for (let i = 0; i < txnWrites; i++)
+                    dbi.put(crypto.randomBytes(16).toString('hex'), value);
+            });
+            peakRss = Math.max(peakRss, process.memoryUsage().rss);
+        };
+        const seconds = Number(process.hrtime.bigint() - start) / 1e9;
+        console.log([
+            `writeMap: ${String(writeMap).padEnd(5)}`,
+            `writes/txn: ${String(txnWrites).padStart(6)}`,
+            `${Math.round(totalWrites / seconds)} writes/s`,
+            `${(totalWrites / txnWrites / seconds).toFixed(1)} commits/s`,
+            `peak RSS: ${Math.round(peakRss / 1024 / 1024)} MB`,
+        ].join(', '));
+    } finally {
+        db.close();
+    };
+}
+
+for (const txnWrites of writesPerTxn) {
+    if (mode != 'on')
+        run(false, txnWrites);
+    if (mode != 'off')
+        run(true, txnWrites);
+};
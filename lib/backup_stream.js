@@ -0,0 +1,28 @@
+const fs = require('fs');
+const net = require('net');
+const os = require('os');
+const { PassThrough } = require('stream');
+
+// Wraps read end of the pipe written by the native backup worker. Pipe end of data is not trusted:
+// the stream ends only when the worker has succeeded, so a failed copy never looks like a complete one.
+function createBackupStream(fd, promise, options = {}) {
+    const source = os.type() == 'Windows_NT'
+        ? fs.createReadStream(null, { fd })
+        : new net.Socket({ fd, readable: true, writable: false });
+    const output = new PassThrough(options);
+
+    const sourceEnded = new Promise(resolve => source.once('end', resolve));
+    source.once('error', error => output.destroy(error));
+    source.pipe(output, { end: false });
+
+    // Destroying the stream closes the pipe, which fails the copy.
+    output.once('close', () => source.destroy());
+
+    promise.then(
+        () => sourceEnded.then(() => output.end()),
+        error => output.destroy(error),
+    );
+    return output;
+}
+
+module.exports = createBackupStream;
\ No newline at end of file
@@ -0,0 +1,92 @@
+const { Readable, Writable } = require('stream');
+
+const DEFAULT_CHUNK_SIZE = 1024 * 1024;
+
+// Streams are bound to the transaction they were created in and should be consumed before its end
+// (e.g. inside asyncTransact action).
+
+class DbiReadStream extends Readable {
+    constructor(dbi, key, options = {}) {
+        const { chunkSize = DEFAULT_CHUNK_SIZE, ...streamOptions } = options;
+        if (!(chunkSize > 0))
+            throw new Error('Wrong chunkSize; should be a positive number.');
+        super({ highWaterMark: chunkSize, ...streamOptions });
+        this._dbi = dbi;
+        this._key = key;
+        this._chunkSize = chunkSize;
+        this._offset = 0;
+        this._txnManager = dbi._txnManager;
+        this._txnId = this._txnManager.txnId;
+    }
+
+    _read() {
+        try {
+            this._txnManager.check(this._txnId);
+            const chunk = this._dbi.getSlice(this._key, this._offset, this._chunkSize);
+            if (chunk === undefined)
+                throw new Error(this._offset == 0 ? 'Key not found.' : 'Value has been deleted.');
+            this._offset += chunk.length;
+            if (chunk.length)
+                this.push(chunk);
+            if (chunk.length < this._chunkSize)
+                this.push(null);
+        } catch(error) {
+            this.destroy(error);
+        };
+    }
+}
+
+class DbiWriteStream extends Writable {
+    constructor(dbi, key, size, options) {
+        super(options);
+        this._txnManager = dbi._txnManager;
+        this._txnId = this._txnManager.txnId;
+        this._buffer = dbi.putReserve(key, size);
+        this._size = size;
+        this._offset = 0;
+    }
+
+    _write(chunk, encoding, callback) {
+        try {
+            this._txnManager.check(this._txnId);
+            // Reserved buffer is detached by any other write.
+            if (this._buffer.length != this._size)
+                throw new Error('Reserved value has been invalidated by another write.');
+            if (this._offset + chunk.length > this._size)
+                throw new Error('Data exceeds reserved size.');
+            chunk.copy(this._buffer, this._offset);
+            this._offset += chunk.length;
+            callback();
+        } catch(error) {
+            callback(error);
+        };
+    }
+
+    _final(callback) {
+        if (this._offset != this._size)
+            return callback(new Error('Data is shorter than reserved size.'));
+        this._buffer = null;
+        callback();
+    }
+}
+
+function createReadStream(key, options) {
+    return new DbiReadStream(this, key, options);
+}
+
+function createWriteStream(key, size, options) {
+    return new DbiWriteStream(this, key, size, options);
+}
+
+// Dbis are native objects, so stream methods are added to their prototype.
+function extendDbi(dbi, txnManager) {
+    dbi._txnManager = txnManager;
+    const prototype = Object.getPrototypeOf(dbi);
+    if (prototype.createReadStream !== createReadStream) {
+        prototype.createReadStream = createReadStream;
+        prototype.createWriteStream = createWriteStream;
+    };
+    return dbi;
+}
+
+exports.extendDbi = extendDbi;
\ No newline at end of file
@@ -4,36 +4,44 @@ const path = require('path');
 const Txn = require('./txn');
 const TxnManager = require('./txn_manager');
 const createDeferred = require('./create_deferred');
+const createBackupStream = require('./backup_stream');
 const { CppMdbx } = require('./native');
 
 class MDBX {
-    constructor(options) {
-        this._cppMdbx = new CppMdbx(options);
-        this._txnManager = new TxnManager(this._cppMdbx);
+    constructor(options, opened) {
+        this._options = options;
+        this._open(opened);
+        this._backgroundReads = 0;
         this._queue = [];
         this._closed = false;
         this._processingTransactionsQueue = false;
         this._processTransactionsQueue = this._processTransactionsQueue.bind(this);
     }
 
+    _open(opened) {
+        this._cppMdbx = new CppMdbx(this._options, opened);
+        this._txnManager = new TxnManager(this._cppMdbx);
+    }
+
     close() {
-        this._closed = true;
+        // Native close throws while a background operation is running; the database stays opened then.
         this._cppMdbx.close();
+        this._closed = true;
     }
 
     get closed() {
         return this._closed;
     }
 
-    _getTransaction() {
-        return new Txn(this._txnManager);
+    _getTransaction(options) {
+        return new Txn(this._txnManager, options);
     }
 
-    transact(action) {
+    transact(action, options) {
         if (typeof(action) != 'function')
             throw new Error('Action is not a function.');
         this._checkClosed();
-        const transaction = this._getTransaction();
+        const transaction = this._getTransaction(options);
         let abort = false;
         try {
             return action(transaction);
@@ -54,11 +62,83 @@ class MDBX {
         };
     }
 
-    async asyncTransact(action) {
+    async asyncTransact(action, options) {
         if (typeof(action) != 'function')
             throw new Error('Action is not a function.');
+        return this._enqueue(action, false, options);
+    }
+
+    async bulkLoad(dbiName, source, options = {}) {
+        const {
+            sorted = false,
+            resume = false,
+            format = 'lengthPrefixed',
+            txnBytes = 64 * 1024 * 1024,
+            dbiOptions,
+            onProgress,
+        } = options;
+        if (resume && !sorted)
+            throw new Error('Resume is only possible for sorted input.');
+
+        const dbi = this.transact(txn => txn.getDbi(dbiName, dbiOptions));
+        const total = { records: 0, skipped: 0, bytes: 0, lastKey: undefined };
+
+        // Each batch is committed by the native worker; other transactions may run in between.
+        const loadBatch = async (batchOptions) => {
+            const result = await this._enqueue(() => {
+                this._checkClosed();
+                return this._cppMdbx.bulkLoadBatch(dbi, {
+                    sorted, resume, format, txnBytes, ...batchOptions,
+                });
+            }, true);
+            total.records += result.records;
+            total.skipped += result.skipped;
+            total.bytes += result.bytes;
+            if (result.lastKey !== undefined)
+                total.lastKey = result.lastKey;
+            if (onProgress)
+                onProgress({ ...total });
+            return result;
+        };
+
+        if (typeof(source) == 'number') {
+            let rest;
+            do {
+                const result = await loadBatch({ fd: source, data: rest });
+                rest = result.rest;
+                if (result.eof && !rest.length)
+                    break;
+            } while (true);
+        } else if (source && typeof(source[Symbol.asyncIterator]) == 'function') {
+            let chunks = [];
+            let size = 0;
+            for await (const chunk of source) {
+                const buffer = Buffer.isBuffer(chunk) ? chunk : Buffer.from(chunk);
+                chunks.push(buffer);
+                size += buffer.length;
+                if (size >= txnBytes) {
+                    const result = await loadBatch({ data: Buffer.concat(chunks) });
+                    chunks = [result.rest];
+                    size = result.rest.length;
+                };
+            };
+            let rest = Buffer.concat(chunks);
+            do {
+                const result = await loadBatch({ data: rest, last: true });
+                rest = result.rest;
+            } while (rest.length);
+        } else {
+            throw new Error('Source should be a file descriptor or an async iterable (e.g. Readable stream).');
+        };
+
+        return total;
+    }
+
+    _enqueue(action, raw, options) {
         const deferred = createDeferred();
         deferred.action = action;
+        deferred.raw = raw;
+        deferred.options = options;
         this._queue.push(deferred);
 
         if (!this._processingTransactionsQueue) {
@@ -73,9 +153,155 @@ class MDBX {
         return this._cppMdbx.hasTransaction();
     }
 
-    async _doTransactAsync(action) {
+    setGeometry(geometry) {
+        this._checkClosed();
+        this._cppMdbx.setGeometry(geometry);
+    }
+
+    setOption(name, value) {
+        this._checkClosed();
+        this._cppMdbx.setOption(name, value);
+    }
+
+    getOption(name) {
+        this._checkClosed();
+        return this._cppMdbx.getOption(name);
+    }
+
+    stats(options = {}) {
+        this._checkClosed();
+        return this._cppMdbx.stats(!!options.resetLatency);
+    }
+
+    gcStats() {
+        this._checkClosed();
+        return this._cppMdbx.gcStats();
+    }
+
+    shrink() {
+        this._checkClosed();
+        return this._cppMdbx.shrink();
+    }
+
+    // Flushes the database on a worker thread; queued after pending async transactions.
+    async sync() {
+        return this._enqueue(() => {
+            this._checkClosed();
+            return this._cppMdbx.sync();
+        }, true);
+    }
+
+    // Writes compacted copy of the database into options.target (which should not exist) on a worker thread;
+    // transactions may run meanwhile. With options.swap the copy replaces the datafile at a quiescent point
+    // (between async transactions) if nothing has been committed since the copy was made, otherwise
+    // the copy is repeated (up to options.retries times).
+    async compact(options = {}) {
+        const {
+            swap = false,
+            retries = 3,
+            progressInterval = 1000,
+            onProgress,
+        } = options;
         this._checkClosed();
-        const transaction = this._getTransaction();
+        if (swap && this._options.readOnly)
+            throw new Error('Database is opened in read-only mode.');
+        const target = options.target !== undefined
+            ? options.target
+            : (swap ? path.join(this._options.path, 'mdbx.dat.compact') : undefined);
+        if (typeof(target) != 'string')
+            throw new Error('Target path is not a string.');
+
+        for (let attempt = 0; ; attempt++) {
+            if (options.target === undefined)
+                removeFile(target);
+            const result = await this._compactCopy(target, progressInterval, onProgress);
+            const report = {
+                attempts: attempt + 1,
+                sourceBytes: result.sourceBytes,
+                targetBytes: result.targetBytes,
+                reclaimedBytes: Math.max(result.sourceBytes - result.targetBytes, 0),
+                swapped: false,
+            };
+            if (!swap)
+                return report;
+
+            const swapped = await this._enqueue(() => {
+                this._checkClosed();
+                if (result.modified || this._cppMdbx.stats().recentTxnId != result.txnId)
+                    return false;
+                this._swapDatafile(target);
+                return true;
+            }, true);
+            if (swapped)
+                return { ...report, swapped };
+
+            removeFile(target);
+            if (attempt >= retries)
+                throw new Error('Database has been modified during each compaction attempt.');
+        };
+    }
+
+    async _compactCopy(target, progressInterval, onProgress) {
+        const { pageSize, lastPage } = this._cppMdbx.stats();
+        const totalBytes = (lastPage + 1) * pageSize;
+        const progress = () => fs.stat(target, (error, stat) => {
+            if (!error)
+                onProgress({ bytesWritten: stat.size, totalBytes });
+        });
+        const timer = onProgress ? setInterval(progress, progressInterval) : null;
+        this._backgroundReads++;
+        try {
+            const result = await this._cppMdbx.compact(target);
+            if (onProgress)
+                onProgress({ bytesWritten: result.targetBytes, totalBytes });
+            return result;
+        } finally {
+            this._backgroundReads--;
+            if (timer)
+                clearInterval(timer);
+        };
+    }
+
+    // Analyzes the opened database on a worker thread from a read snapshot, see static analyze().
+    async analyze(options) {
+        this._checkClosed();
+        const promise = this._cppMdbx.analyze(options);
+        this._backgroundReads++;
+        try {
+            return await promise;
+        } finally {
+            this._backgroundReads--;
+        };
+    }
+
+    // Streams consistent copy of the database written on a worker thread from a read snapshot.
+    backupStream(options = {}) {
+        const { compact = false, ...streamOptions } = options;
+        this._checkClosed();
+        const { fd, promise } = this._cppMdbx.backup(compact);
+        this._backgroundReads++;
+        const done = promise.finally(() => this._backgroundReads--);
+        return createBackupStream(fd, done, streamOptions);
+    }
+
+    // Should be called between transactions. Other processes would keep the replaced datafile mapped,
+    // so the swap is refused while any of them has the database opened.
+    _swapDatafile(source) {
+        if (this._backgroundReads > 0)
+            throw new Error('Database is used by a background operation.');
+        if (this._cppMdbx.isUsedByOtherProcesses())
+            throw new Error('Database is opened by another process.');
+        this._cppMdbx.close();
+        try {
+            fs.renameSync(source, path.join(this._options.path, 'mdbx.dat'));
+        } finally {
+            this._open();
+        };
+    }
+
+    async _doTransactAsync(action, options) {
+        this._checkClosed();
+        const transaction = this._getTransaction(options);
         let abort = false;
         try {
             return await action(transaction);
@@ -100,7 +326,9 @@ class MDBX {
         while (this._queue.length) {
             const deferred = this._queue.shift();
             try {
-                const result = await this._doTransactAsync(deferred.action);
+                const result = deferred.raw
+                    ? await deferred.action()
+                    : await this._doTransactAsync(deferred.action, deferred.options);
                 deferred.resolve(result);
             } catch(error) {
                 deferred.reject(error);
@@ -114,14 +342,30 @@ class MDBX {
             throw new Error('Database has been closed.');
     }
 
+    // Opens the environment and declared dbis on a worker thread.
+    static async open(options) {
+        const opened = await CppMdbx.openAsync(options);
+        return new MDBX(options, opened);
+    }
+
+    // Walks pages and samples records of the database on a worker thread to recommend page size and geometry.
+    // Database should not be opened by this process (see analyze() of the instance).
+    static async analyze(dbPath, options) {
+        return CppMdbx.analyze(dbPath, options);
+    }
+
     static clearDb(dbPath) {
-        try {
-            fs.unlinkSync(path.join(dbPath, 'mdbx.dat'));
-        } catch(error) {
-            if (error.code != 'ENOENT')
-                throw error;
-        };
+        removeFile(path.join(dbPath, 'mdbx.dat'));
     }
 }
 
+function removeFile(filePath) {
+    try {
+        fs.unlinkSync(filePath);
+    } catch(error) {
+        if (error.code != 'ENOENT')
+            throw error;
+    };
+}
+
 module.exports = MDBX;
\ No newline at end of file
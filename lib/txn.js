@@ -1,41 +1,104 @@
 class Txn {
-    constructor(txnManager) {
+    constructor(txnManager, options) {
         this._txnManager = txnManager;
-        this._txnId = txnManager.beginTransaction();
+        this._txnId = txnManager.beginTransaction(options);
+        this._level = txnManager.level;
+        this._savepoints = [];
     }
 
     _finish() {
         this._txnManager = null;
         this._txnId = 0;
+        this._savepoints = [];
     }
 
-    getDbi(name) {
-        return this._txnManager.getDbi(name);
+    getDbi(name, options) {
+        return this._txnManager.getDbi(name, options);
     }
 
     clearDbi(name, remove) {
         return this._txnManager.clearDbi(this._txnId, name, remove);
     }
 
+    dirtyBytes() {
+        return this._txnManager.dirtyBytes(this._txnId);
+    }
+
     finished() {
         return this._txnManager == null;
     }
 
+    savepoint() {
+        this._checkFinished();
+        this._checkLevel();
+        if (!this._txnManager.nested)
+            throw new Error('Savepoints are not supported in read-only and writeMap modes.');
+        this._txnManager.beginTransaction();
+        const savepoint = { level: this._txnManager.level };
+        this._savepoints.push(savepoint);
+        return savepoint;
+    }
+
+    // Rollbacks changes made after the savepoint (including later savepoints). The savepoint remains valid.
+    rollbackTo(savepoint) {
+        const index = this._findSavepoint(savepoint);
+        while (this._savepoints.length > index)
+            this._txnManager.abortTransaction(this._txnId, this._savepoints.pop().level);
+        this._txnManager.beginTransaction();
+        this._savepoints.push(savepoint);
+    }
+
+    // Keeps changes made after the savepoint and forgets it (and later savepoints).
+    releaseSavepoint(savepoint) {
+        const index = this._findSavepoint(savepoint);
+        while (this._savepoints.length > index)
+            this._txnManager.commitTransaction(this._txnId, this._savepoints.pop().level);
+    }
+
     commit() {
+        this._checkLevel();
         try {
-            this._txnManager.commitTransaction(this._txnId);
+            while (this._savepoints.length)
+                this._txnManager.commitTransaction(this._txnId, this._savepoints.pop().level);
+            this._txnManager.commitTransaction(this._txnId, this._level);
         } finally {
             this._finish();
         };
     }
 
     abort() {
+        this._checkLevel();
         try {
-            this._txnManager.abortTransaction(this._txnId);
+            while (this._savepoints.length)
+                this._txnManager.abortTransaction(this._txnId, this._savepoints.pop().level);
+            this._txnManager.abortTransaction(this._txnId, this._level);
         } finally {
             this._finish();
         };
     }
+
+    _findSavepoint(savepoint) {
+        this._checkFinished();
+        this._checkLevel();
+        const index = this._savepoints.indexOf(savepoint);
+        if (index < 0)
+            throw new Error('Unknown savepoint.');
+        return index;
+    }
+
+    // Transactions started inside this one (by nested transact calls) should be finished first.
+    _checkLevel() {
+        if (this.finished())
+            return;
+        const last = this._savepoints[this._savepoints.length - 1];
+        if (this._txnManager.level > (last ? last.level : this._level))
+            throw new Error('Nested transaction is still active.');
+    }
+
+    _checkFinished() {
+        if (this.finished())
+            throw new Error('Transaction is finished.');
+    }
 };
 
 exports = module.exports = Txn;
\ No newline at end of file
@@ -1,45 +1,87 @@
+const { extendDbi } = require('./dbi_streams');
+
 const mainDbi = Symbol();
 
 class TxnManager {
     constructor(cppMdbx) {
         this._cppMdbx = cppMdbx;
         this._dbis = Object.create(null);
+        // Cached dbis are valid while the generation shared with native code stays the same.
+        this._dbiGeneration = cppMdbx.dbiGeneration();
+        this._dbisGeneration = this._dbiGeneration[0];
         this._txnCounter = 0;
         this._txnId = 1;
+        // Otherwise nested transactions are flattened: only the top-level one commits or rollbacks.
+        this._nested = cppMdbx.supportsNestedTransactions();
     }
 
-    beginTransaction() {
-        if (this._txnCounter == 0)
-            this._cppMdbx.beginTransaction();
-        this._txnCounter++;
+    get level() {
+        return this._txnCounter;
+    }
+
+    get nested() {
+        return this._nested;
+    }
+
+    get txnId() {
         return this._txnId;
     }
 
-    commitTransaction(txnId) {
+    check(txnId) {
         this._check(txnId);
+    }
+
+    // Options of nested transactions are ignored: they are part of the outer one.
+    beginTransaction(options) {
+        if (this._txnCounter == 0) {
+            const { autoSplitBytes, writeBufferBytes } = options || {};
+            this._cppMdbx.beginTransaction(autoSplitBytes, writeBufferBytes);
+        } else if (this._nested) {
+            this._cppMdbx.beginNestedTransaction();
+        };
+        this._txnCounter++;
+        return this._txnId;
+    }
+
+    commitTransaction(txnId, level) {
+        this._check(txnId, level);
         this._txnCounter--;
         if (this._txnCounter == 0) {
             this._txnId++;
             this._cppMdbx.commitTransaction();
+        } else if (this._nested) {
+            this._cppMdbx.commitNestedTransaction();
         };
     }
 
-    abortTransaction(txnId) {
-        this._check(txnId);
+    abortTransaction(txnId, level) {
+        this._check(txnId, level);
         this._txnCounter--;
         if (this._txnCounter == 0) {
             this._txnId++;
             this._cppMdbx.abortTransaction();
+        } else if (this._nested) {
+            this._cppMdbx.abortNestedTransaction();
         };
     }
 
-    getDbi(name) {
+    dirtyBytes(txnId) {
+        this._check(txnId);
+        return this._cppMdbx.dirtyBytes();
+    }
+
+    getDbi(name, options) {
+        if (this._dbisGeneration != this._dbiGeneration[0]) {
+            this._dbis = Object.create(null);
+            this._dbisGeneration = this._dbiGeneration[0];
+        };
         const fixedName = this._fixName(name);
         let dbi = this._dbis[fixedName];
-        if (dbi && dbi.isStale())
+        // Options of the cached dbi are checked natively; mismatch is reported by getDbi of native code.
+        if (dbi && options != null && !this._cppMdbx.isDbiOpenedWith(name, options))
             dbi = undefined;
         if (!dbi)
-            dbi = this._dbis[fixedName] = this._cppMdbx.getDbi(name);
+            dbi = this._dbis[fixedName] = extendDbi(this._cppMdbx.getDbi(name, options), this);
         return dbi;
     }
 
@@ -50,9 +92,11 @@ class TxnManager {
         return this._cppMdbx.clearDbi(name, !!remove);
     }
 
-    _check(txnId) {
+    _check(txnId, level) {
         if (txnId != this._txnId)
             throw new Error('Stale transaction.');
+        if (level !== undefined && level != this._txnCounter)
+            throw new Error('Nested transaction is still active.');
     }
 
     _fixName(name) {
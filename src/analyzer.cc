@@ -0,0 +1,402 @@
+#include "analyzer.h"
+#include "comparators.h"
+#include "db_exception.h"
+
+#include <cmath>
+
+static const unsigned MIN_CANDIDATE_PAGE_SIZE = 1024;
+static const unsigned MAX_CANDIDATE_PAGE_SIZE = 65536;
+// Page layout constants of MDBX (see PAGEHDRSZ, NODESIZE and LEAF_NODE_MAX in mdbx.c).
+static const unsigned PAGE_HEADER_SIZE = 20;
+static const unsigned NODE_HEADER_SIZE = 8;
+static const unsigned NODE_INDEX_SIZE = 2;
+static const unsigned META_PAGES = 3;
+// Fill of leaf pages if it can't be measured.
+static const double DEFAULT_FILL = 0.75;
+// Smaller page size is preferred if its estimation is within this part of the best one.
+static const double RECOMMENDATION_TOLERANCE = 0.05;
+
+static uint64_t Even(uint64_t n) {
+    return (n + 1) & ~(uint64_t) 1;
+}
+
+static uint64_t LeafNodeMax(unsigned pageSize) {
+    return (((pageSize - PAGE_HEADER_SIZE) / 2) & ~1u) - NODE_INDEX_SIZE;
+}
+
+static uint64_t CeilPowerOf2(uint64_t n) {
+    uint64_t result = 1;
+    while (result < n)
+        result <<= 1;
+    return result;
+}
+
+void SizeHistogram::Add(uint64_t size) {
+    unsigned bucket = 0;
+    while (bucket + 1 < BUCKETS && (size >> bucket) != 0)
+        bucket++;
+    buckets[bucket]++;
+    count++;
+    total += size;
+    if (size > max)
+        max = size;
+}
+
+static Napi::Object HistogramToObject(Napi::Env env, const SizeHistogram &histogram) {
+    Napi::Array buckets = Napi::Array::New(env);
+    for (unsigned i = 0; i < SizeHistogram::BUCKETS; i++) {
+        if (histogram.buckets[i] == 0)
+            continue;
+        Napi::Object bucket = Napi::Object::New(env);
+        bucket.Set("lessThan", (double) ((uint64_t) 1 << i));
+        bucket.Set("count", (double) histogram.buckets[i]);
+        buckets.Set(buckets.Length(), bucket);
+    };
+
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("count", (double) histogram.count);
+    result.Set("average", histogram.count ? (double) histogram.total / histogram.count : 0.0);
+    result.Set("max", (double) histogram.max);
+    result.Set("buckets", buckets);
+    return result;
+}
+
+AnalyzeWorker::AnalyzeWorker(Napi::Env env, AnalyzeParameters &&parameters):
+    Napi::AsyncWorker(env),
+    _parameters(std::move(parameters)),
+    _deferred(Napi::Promise::Deferred::New(env))
+{
+    for (unsigned pageSize = MIN_CANDIDATE_PAGE_SIZE; pageSize <= MAX_CANDIDATE_PAGE_SIZE; pageSize *= 2) {
+        PageSizeEstimate estimate;
+        estimate.pageSize = pageSize;
+        _estimates.push_back(estimate);
+    };
+}
+
+AnalyzeWorker::AnalyzeWorker(Napi::Env env, const DbEnvPtr &dbEnvPtr, AnalyzeParameters &&parameters):
+    AnalyzeWorker(env, std::move(parameters))
+{
+    _dbEnvPtr = dbEnvPtr;
+    _env = _dbEnvPtr->GetEnv();
+    _dbEnvPtr->AddBackgroundReader();
+}
+
+AnalyzeWorker::~AnalyzeWorker() {
+    _release();
+}
+
+Napi::Promise AnalyzeWorker::GetPromise() {
+    return _deferred.Promise();
+}
+
+void AnalyzeWorker::Execute() {
+    if (_env) {
+        try {
+            _analyze(_env);
+            _estimate();
+        } catch(std::exception &e) {
+            SetError(e.what());
+        };
+        return;
+    };
+
+    MDBX_env *env = NULL;
+    try {
+        int rc = mdbx_env_create(&env);
+        CheckMdbxResult(rc);
+        rc = mdbx_env_set_maxdbs(env, (MDBX_dbi) _parameters.maxDbs);
+        CheckMdbxResult(rc);
+        rc = mdbx_env_open(env, _parameters.dbPath.c_str(), MDBX_RDONLY, 0);
+        CheckMdbxResult(rc);
+
+        _analyze(env);
+        _estimate();
+    } catch(std::exception &e) {
+        SetError(e.what());
+    };
+    if (env)
+        mdbx_env_close(env);
+}
+
+int AnalyzeWorker::_visitPage(
+    const uint64_t, const unsigned number, void *const ctx, const int,
+    const char *const dbi, const size_t, const MDBX_page_type_t type,
+    const MDBX_error_t err, const size_t, const size_t payloadBytes,
+    const size_t, const size_t unusedBytes) MDBX_CXX17_NOEXCEPT
+{
+    AnalyzeWorker &self = *(AnalyzeWorker *) ctx;
+
+    if (err != MDBX_SUCCESS || type == MDBX_page_broken) {
+        self._brokenPages += number;
+        return MDBX_SUCCESS;
+    };
+    if (dbi == MDBX_PGWALK_META) {
+        self._metaPages += number;
+        return MDBX_SUCCESS;
+    };
+    if (dbi == MDBX_PGWALK_GC) {
+        self._gcPages += number;
+        return MDBX_SUCCESS;
+    };
+
+    try {
+        DbiAnalysis &analysis = self._dbis[dbi == MDBX_PGWALK_MAIN ? std::string() : std::string(dbi)];
+        switch (type) {
+            case MDBX_page_branch:
+                analysis.branchPages += number;
+                analysis.payloadBytes += payloadBytes;
+                analysis.unusedBytes += unusedBytes;
+                break;
+            case MDBX_page_leaf:
+            case MDBX_page_dupfixed_leaf:
+                analysis.leafPages += number;
+                analysis.payloadBytes += payloadBytes;
+                analysis.unusedBytes += unusedBytes;
+                break;
+            case MDBX_page_large:
+                analysis.largeValues++;
+                analysis.largePages += number;
+                break;
+            default:
+                // Sub-pages are parts of leaf pages.
+                break;
+        };
+    } catch(std::exception &) {
+        return MDBX_ENOMEM;
+    };
+    return MDBX_SUCCESS;
+}
+
+void AnalyzeWorker::_analyze(MDBX_env *env) {
+    MDBX_envinfo info;
+    int rc = mdbx_env_info_ex(env, NULL, &info, sizeof(info));
+    CheckMdbxResult(rc);
+    _pageSize = info.mi_dxb_pagesize;
+    _totalPages = info.mi_geo.current / info.mi_dxb_pagesize;
+    _usedPages = info.mi_last_pgno + 1;
+
+    MDBX_txn *txn = NULL;
+    rc = mdbx_txn_begin(env, NULL, MDBX_TXN_RDONLY, &txn);
+    CheckMdbxResult(rc);
+
+    try {
+        _dbis[std::string()];
+        rc = mdbx_env_pgwalk(txn, _visitPage, this, true);
+        CheckMdbxResult(rc);
+
+        uint64_t leafPayload = 0;
+        uint64_t leafSpace = 0;
+        std::set<std::string> names;
+        for (auto &item : _dbis) {
+            DbiAnalysis &analysis = item.second;
+            if (analysis.leafPages > 0) {
+                leafPayload += analysis.payloadBytes;
+                leafSpace += analysis.payloadBytes + analysis.unusedBytes;
+            };
+            if (!item.first.empty())
+                names.insert(item.first);
+        };
+        _leafFill = leafSpace ? (double) leafPayload / leafSpace : 0;
+        // Service dbi of key comparators is not reported (but still skipped in records of the main dbi).
+        _dbis.erase(KEY_COMPARATORS_DBI);
+
+        for (auto &item : _dbis) {
+            const std::string &name = item.first;
+            // Handles are shared with the opened environment, so they should be opened the same way.
+            MDBX_dbi dbi = 0;
+            rc = DbEnv::OpenExistingDbi(txn, name, &dbi);
+            // Handles of the opened environment may be exhausted; such dbis are not sampled then.
+            if (rc == MDBX_DBS_FULL)
+                continue;
+            CheckMdbxResult(rc);
+            // Records of the main dbi include named dbis themselves.
+            _sampleDbi(txn, dbi, item.second, name.empty() ? &names : NULL);
+        };
+    } catch(...) {
+        mdbx_txn_abort(txn);
+        throw;
+    };
+    mdbx_txn_abort(txn);
+}
+
+void AnalyzeWorker::_sampleDbi(MDBX_txn *txn, MDBX_dbi dbi, DbiAnalysis &analysis, const std::set<std::string> *skipKeys) {
+    MDBX_stat stat;
+    int rc = mdbx_dbi_stat(txn, dbi, &stat, sizeof(stat));
+    CheckMdbxResult(rc);
+    analysis.entries = stat.ms_entries;
+    if (skipKeys)
+        analysis.entries -= std::min<uint64_t>(skipKeys->size(), analysis.entries);
+
+    std::vector<PageSizeEstimate> estimates(_estimates.size());
+    std::vector<uint64_t> keysizeMax;
+    for (const auto &estimate : _estimates)
+        keysizeMax.push_back(mdbx_limits_keysize_max(estimate.pageSize, MDBX_DB_DEFAULTS));
+
+    MDBX_cursor *dbCur = NULL;
+    rc = mdbx_cursor_open(txn, dbi, &dbCur);
+    CheckMdbxResult(rc);
+
+    try {
+        MDBX_val key, value;
+        rc = mdbx_cursor_get(dbCur, &key, &value, MDBX_FIRST);
+        while (rc == MDBX_SUCCESS && analysis.sampled < _parameters.sampleLimit) {
+            if (!skipKeys || !skipKeys->count(std::string((const char *) key.iov_base, key.iov_len))) {
+                analysis.sampled++;
+                analysis.keySizes.Add(key.iov_len);
+                analysis.valueSizes.Add(value.iov_len);
+
+                for (size_t i = 0; i < estimates.size(); i++) {
+                    PageSizeEstimate &estimate = estimates[i];
+                    const unsigned pageSize = _estimates[i].pageSize;
+                    const uint64_t node = NODE_HEADER_SIZE + key.iov_len + value.iov_len;
+                    if (node > LeafNodeMax(pageSize)) {
+                        // Value is moved to large pages, node keeps its page number.
+                        estimate.leafBytes += Even(NODE_HEADER_SIZE + key.iov_len + sizeof(uint32_t)) + NODE_INDEX_SIZE;
+                        estimate.largeValues++;
+                        estimate.largePages += (PAGE_HEADER_SIZE + value.iov_len + pageSize - 1) / pageSize;
+                    } else {
+                        estimate.leafBytes += Even(node) + NODE_INDEX_SIZE;
+                    };
+                    if (key.iov_len > keysizeMax[i])
+                        estimate.keysFit = false;
+                };
+            };
+            rc = mdbx_cursor_get(dbCur, &key, &value, MDBX_NEXT);
+        };
+        if (rc != MDBX_SUCCESS && rc != MDBX_NOTFOUND)
+            CheckMdbxResult(rc);
+    } catch(...) {
+        mdbx_cursor_close(dbCur);
+        throw;
+    };
+    mdbx_cursor_close(dbCur);
+
+    const double scale = analysis.sampled ? (double) analysis.entries / analysis.sampled : 0;
+    for (size_t i = 0; i < estimates.size(); i++) {
+        _estimates[i].leafBytes += estimates[i].leafBytes * scale;
+        _estimates[i].largeValues += estimates[i].largeValues * scale;
+        _estimates[i].largePages += estimates[i].largePages * scale;
+        _estimates[i].keysFit = _estimates[i].keysFit && estimates[i].keysFit;
+    };
+}
+
+void AnalyzeWorker::_estimate() {
+    uint64_t keyCount = 0;
+    uint64_t keyBytes = 0;
+    for (const auto &item : _dbis) {
+        keyCount += item.second.keySizes.count;
+        keyBytes += item.second.keySizes.total;
+    };
+    const double averageKey = keyCount ? (double) keyBytes / keyCount : 0;
+    const double fill = _leafFill > 0 ? std::min(std::max(_leafFill, 0.5), 1.0) : DEFAULT_FILL;
+
+    for (auto &estimate : _estimates) {
+        const double room = (estimate.pageSize - PAGE_HEADER_SIZE) * fill;
+        estimate.leafPages = (uint64_t) std::ceil(estimate.leafBytes / room);
+        // Branch nodes hold keys and page numbers; levels above the leaves sum up to leaves / (fanout - 1).
+        const double fanout = std::max(room / (Even(NODE_HEADER_SIZE + averageKey) + NODE_INDEX_SIZE), 2.0);
+        estimate.branchPages = estimate.leafPages > 1 ? (uint64_t) std::ceil(estimate.leafPages / (fanout - 1)) : 0;
+        const uint64_t pages = META_PAGES + estimate.leafPages + estimate.branchPages + (uint64_t) std::ceil(estimate.largePages);
+        estimate.totalBytes = pages * estimate.pageSize;
+    };
+
+    uint64_t best = 0;
+    for (const auto &estimate : _estimates) {
+        if (estimate.keysFit && (best == 0 || estimate.totalBytes < best))
+            best = estimate.totalBytes;
+    };
+    _recommended = 0;
+    for (size_t i = 0; i < _estimates.size(); i++) {
+        if (_estimates[i].keysFit && _estimates[i].totalBytes <= best * (1 + RECOMMENDATION_TOLERANCE)) {
+            _recommended = i;
+            break;
+        };
+    };
+}
+
+void AnalyzeWorker::OnOK() {
+    Napi::Env env = Env();
+    _release();
+
+    Napi::Object pages = Napi::Object::New(env);
+    pages.Set("total", (double) _totalPages);
+    pages.Set("used", (double) _usedPages);
+    pages.Set("meta", (double) _metaPages);
+    pages.Set("gc", (double) _gcPages);
+    pages.Set("broken", (double) _brokenPages);
+    uint64_t branchPages = 0;
+    uint64_t leafPages = 0;
+    uint64_t largePages = 0;
+    for (const auto &item : _dbis) {
+        branchPages += item.second.branchPages;
+        leafPages += item.second.leafPages;
+        largePages += item.second.largePages;
+    };
+    pages.Set("branch", (double) branchPages);
+    pages.Set("leaf", (double) leafPages);
+    pages.Set("large", (double) largePages);
+
+    Napi::Object dbis = Napi::Object::New(env);
+    for (const auto &item : _dbis) {
+        const DbiAnalysis &analysis = item.second;
+        Napi::Object dbi = Napi::Object::New(env);
+        dbi.Set("entries", (double) analysis.entries);
+        dbi.Set("sampled", (double) analysis.sampled);
+        dbi.Set("branchPages", (double) analysis.branchPages);
+        dbi.Set("leafPages", (double) analysis.leafPages);
+        dbi.Set("largePages", (double) analysis.largePages);
+        dbi.Set("largeValues", (double) analysis.largeValues);
+        dbi.Set("payloadBytes", (double) analysis.payloadBytes);
+        dbi.Set("unusedBytes", (double) analysis.unusedBytes);
+        dbi.Set("keySizes", HistogramToObject(env, analysis.keySizes));
+        dbi.Set("valueSizes", HistogramToObject(env, analysis.valueSizes));
+        dbis.Set(item.first, dbi);
+    };
+
+    Napi::Array estimates = Napi::Array::New(env);
+    for (const auto &estimate : _estimates) {
+        Napi::Object item = Napi::Object::New(env);
+        item.Set("pageSize", estimate.pageSize);
+        item.Set("keysFit", estimate.keysFit);
+        item.Set("leafPages", (double) estimate.leafPages);
+        item.Set("branchPages", (double) estimate.branchPages);
+        item.Set("largePages", std::ceil(estimate.largePages));
+        item.Set("largeValues", std::round(estimate.largeValues));
+        item.Set("totalBytes", (double) estimate.totalBytes);
+        estimates.Set(estimates.Length(), item);
+    };
+
+    // Geometry leaves room for growth; growth step is about 1/16 of the data.
+    const uint64_t dataBytes = _estimates[_recommended].totalBytes;
+    const uint64_t growthStep = std::min(std::max(CeilPowerOf2(dataBytes / 16), (uint64_t)MB), (uint64_t)(256 * MB));
+    const uint64_t sizeNow = (dataBytes + dataBytes / 4 + growthStep - 1) / growthStep * growthStep;
+    Napi::Object geometry = Napi::Object::New(env);
+    geometry.Set("sizeNow", (double) sizeNow);
+    geometry.Set("growthStep", (double) growthStep);
+    geometry.Set("shrinkThreshold", (double) (growthStep * 2));
+
+    Napi::Object recommendation = Napi::Object::New(env);
+    recommendation.Set("pageSize", _estimates[_recommended].pageSize);
+    recommendation.Set("geometry", geometry);
+
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("pageSize", _pageSize);
+    result.Set("leafFill", _leafFill);
+    result.Set("pages", pages);
+    result.Set("dbis", dbis);
+    result.Set("estimates", estimates);
+    result.Set("recommendation", recommendation);
+    _deferred.Resolve(result);
+}
+
+void AnalyzeWorker::OnError(const Napi::Error &error) {
+    _release();
+    _deferred.Reject(error.Value());
+}
+
+void AnalyzeWorker::_release() {
+    if (_dbEnvPtr) {
+        _dbEnvPtr->ReleaseBackgroundReader();
+        _dbEnvPtr.reset();
+    };
+}
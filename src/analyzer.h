@@ -0,0 +1,102 @@
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <napi.h>
+#include "mdbx.h"
+
+#include "db_env.h"
+
+// Counts of sizes by powers of 2: bucket i holds sizes less than 2^i (and not less than 2^(i-1)).
+struct SizeHistogram {
+    static const unsigned BUCKETS = 33;
+
+    uint64_t buckets[BUCKETS] = {};
+    uint64_t count = 0;
+    uint64_t total = 0;
+    uint64_t max = 0;
+
+    void Add(uint64_t size);
+};
+
+struct DbiAnalysis {
+    uint64_t entries = 0;
+    uint64_t sampled = 0;
+    uint64_t branchPages = 0;
+    uint64_t leafPages = 0;
+    // Values stored on large (overflow) pages and the number of such pages.
+    uint64_t largeValues = 0;
+    uint64_t largePages = 0;
+    uint64_t payloadBytes = 0;
+    uint64_t unusedBytes = 0;
+    SizeHistogram keySizes;
+    SizeHistogram valueSizes;
+};
+
+// Layout of sampled records simulated with another page size.
+struct PageSizeEstimate {
+    unsigned pageSize = 0;
+    bool keysFit = true;
+    double leafBytes = 0;
+    double largeValues = 0;
+    double largePages = 0;
+    uint64_t leafPages = 0;
+    uint64_t branchPages = 0;
+    uint64_t totalBytes = 0;
+};
+
+struct AnalyzeParameters {
+    // Database opened by path (not used for the opened environment).
+    std::string dbPath;
+    unsigned maxDbs = 1024;
+    // Records scanned per dbi; estimations for bigger dbis are extrapolated.
+    uint64_t sampleLimit = 1000000;
+};
+
+// Walks pages of an existing database (mdbx_env_pgwalk) and samples its records on a worker thread,
+// then estimates the layout for other page sizes to recommend page size and geometry.
+// Database is either opened by path in read-only mode, or the opened environment is read in a read transaction.
+class AnalyzeWorker : public Napi::AsyncWorker {
+public:
+    AnalyzeWorker(Napi::Env env, AnalyzeParameters &&parameters);
+    AnalyzeWorker(Napi::Env env, const DbEnvPtr &dbEnvPtr, AnalyzeParameters &&parameters);
+    ~AnalyzeWorker();
+
+    Napi::Promise GetPromise();
+
+protected:
+    void Execute() override;
+    void OnOK() override;
+    void OnError(const Napi::Error &error) override;
+
+private:
+    static int _visitPage(
+        const uint64_t pgno, const unsigned number, void *const ctx, const int deep,
+        const char *const dbi, const size_t pageSize, const MDBX_page_type_t type,
+        const MDBX_error_t err, const size_t entries, const size_t payloadBytes,
+        const size_t headerBytes, const size_t unusedBytes) MDBX_CXX17_NOEXCEPT;
+
+    void _analyze(MDBX_env *env);
+    void _sampleDbi(MDBX_txn *txn, MDBX_dbi dbi, DbiAnalysis &analysis, const std::set<std::string> *skipKeys);
+    void _estimate();
+    void _release();
+
+    DbEnvPtr _dbEnvPtr;
+    MDBX_env *_env = NULL;
+    AnalyzeParameters _parameters;
+    Napi::Promise::Deferred _deferred;
+
+    unsigned _pageSize = 0;
+    uint64_t _totalPages = 0;
+    uint64_t _usedPages = 0;
+    uint64_t _metaPages = 0;
+    uint64_t _gcPages = 0;
+    uint64_t _brokenPages = 0;
+    double _leafFill = 0;
+    std::map<std::string, DbiAnalysis> _dbis;
+    std::vector<PageSizeEstimate> _estimates;
+    size_t _recommended = 0;
+};
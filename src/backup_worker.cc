@@ -0,0 +1,104 @@
+#include "backup_worker.h"
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+static const unsigned PIPE_BUFFER_SIZE = 1024 * 1024;
+
+static void CreatePipe(Napi::Env env, int &readFd, int &writeFd) {
+    int fds[2];
+#ifdef _WIN32
+    if (_pipe(fds, PIPE_BUFFER_SIZE, _O_BINARY | _O_NOINHERIT) != 0)
+        throw Napi::Error::New(env, std::string("Can't create pipe: ") + strerror(errno));
+#else
+    if (pipe(fds) != 0)
+        throw Napi::Error::New(env, std::string("Can't create pipe: ") + strerror(errno));
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+#ifdef F_SETPIPE_SZ
+    fcntl(fds[1], F_SETPIPE_SZ, PIPE_BUFFER_SIZE);
+#endif
+#endif
+    readFd = fds[0];
+    writeFd = fds[1];
+}
+
+static void CloseFd(int fd) {
+#ifdef _WIN32
+    _close(fd);
+#else
+    close(fd);
+#endif
+}
+
+BackupWorker::BackupWorker(Napi::Env env, const DbEnvPtr &dbEnvPtr, bool compact):
+    Napi::AsyncWorker(env),
+    _dbEnvPtr(dbEnvPtr),
+    _compact(compact),
+    _deferred(Napi::Promise::Deferred::New(env))
+{
+    if (_dbEnvPtr->IsBusy())
+        throw Napi::Error::New(env, "Database is busy with a background operation.");
+    _env = _dbEnvPtr->GetEnv();
+    CreatePipe(env, _readFd, _writeFd);
+    _dbEnvPtr->AddBackgroundReader();
+}
+
+BackupWorker::~BackupWorker() {
+    _closeWriteEnd();
+    _release();
+}
+
+Napi::Promise BackupWorker::GetPromise() {
+    return _deferred.Promise();
+}
+
+int BackupWorker::GetReadFd() {
+    return _readFd;
+}
+
+void BackupWorker::Execute() {
+#ifdef _WIN32
+    const mdbx_filehandle_t fd = (mdbx_filehandle_t) _get_osfhandle(_writeFd);
+#else
+    const mdbx_filehandle_t fd = _writeFd;
+#endif
+    const int rc = mdbx_env_copy2fd(_env, fd, _compact ? MDBX_CP_COMPACT : MDBX_CP_DEFAULTS);
+    // Reader sees the end of data only after successful copy (see OnError).
+    if (rc == MDBX_SUCCESS)
+        _closeWriteEnd();
+    else
+        SetError(mdbx_strerror(rc));
+}
+
+void BackupWorker::OnOK() {
+    _release();
+    _deferred.Resolve(Env().Undefined());
+}
+
+void BackupWorker::OnError(const Napi::Error &error) {
+    _release();
+    _deferred.Reject(error.Value());
+}
+
+void BackupWorker::_closeWriteEnd() {
+    if (_writeFd >= 0) {
+        CloseFd(_writeFd);
+        _writeFd = -1;
+    };
+}
+
+void BackupWorker::_release() {
+    if (_dbEnvPtr) {
+        _dbEnvPtr->ReleaseBackgroundReader();
+        _dbEnvPtr.reset();
+    };
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <napi.h>
+#include "mdbx.h"
+
+#include "db_env.h"
+
+// Writes consistent copy of the database (mdbx_env_copy2fd) into a pipe on a worker thread.
+// Read end of the pipe is consumed by JS; the worker blocks while the pipe is full, holding a read snapshot.
+// Non-compact copy also takes the write lock briefly at the start, while meta pages are snapshotted
+// (so it waits for a pending write transaction), but never while the pipe is being written.
+class BackupWorker : public Napi::AsyncWorker {
+public:
+    BackupWorker(Napi::Env env, const DbEnvPtr &dbEnvPtr, bool compact);
+    ~BackupWorker();
+
+    Napi::Promise GetPromise();
+    // File descriptor of the read end of the pipe; it is owned by the caller.
+    int GetReadFd();
+
+protected:
+    void Execute() override;
+    void OnOK() override;
+    void OnError(const Napi::Error &error) override;
+
+private:
+    void _closeWriteEnd();
+    void _release();
+
+    DbEnvPtr _dbEnvPtr;
+    MDBX_env *_env = NULL;
+    bool _compact = false;
+    Napi::Promise::Deferred _deferred;
+
+    int _readFd = -1;
+    int _writeFd = -1;
+};
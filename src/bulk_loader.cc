@@ -0,0 +1,246 @@
+#include "bulk_loader.h"
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+static const size_t READ_CHUNK_SIZE = MB;
+
+static uint32_t ReadUint32LE(const char *data) {
+    const uint8_t *bytes = (const uint8_t *) data;
+    return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((uint32_t) bytes[3] << 24);
+}
+
+BulkLoadWorker::BulkLoadWorker(Napi::Env env, const DbEnvPtr &dbEnvPtr, BulkLoadParameters &&parameters):
+    Napi::AsyncWorker(env),
+    _dbEnvPtr(dbEnvPtr),
+    _parameters(std::move(parameters)),
+    _deferred(Napi::Promise::Deferred::New(env))
+{
+    if (_dbEnvPtr->HasTransaction())
+        throw Napi::Error::New(env, "Bulk load can't be started inside a transaction.");
+    if (_dbEnvPtr->IsBusy())
+        throw Napi::Error::New(env, "Database is busy with a background operation.");
+    if (_dbEnvPtr->IsReadOnly())
+        throw Napi::Error::New(env, "Database is opened in read-only mode.");
+    _env = _dbEnvPtr->GetEnv();
+    _dbEnvPtr->SetBusy(true);
+}
+
+BulkLoadWorker::~BulkLoadWorker() {
+    _release();
+}
+
+Napi::Promise BulkLoadWorker::GetPromise() {
+    return _deferred.Promise();
+}
+
+void BulkLoadWorker::Execute() {
+    MDBX_txn *txn = NULL;
+    try {
+        int rc = mdbx_txn_begin(_env, NULL, MDBX_TXN_READWRITE, &txn);
+        CheckMdbxResult(rc);
+
+        _load(txn);
+
+        rc = mdbx_txn_commit(txn);
+        txn = NULL;
+        CheckMdbxResult(rc);
+    } catch(std::exception &e) {
+        if (txn)
+            mdbx_txn_abort(txn);
+        SetError(e.what());
+    };
+}
+
+void BulkLoadWorker::OnOK() {
+    Napi::Env env = Env();
+    const bool stringKeyMode = _dbEnvPtr->IsStringKeyMode();
+    _release();
+
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("records", (double) _records);
+    result.Set("skipped", (double) _skipped);
+    result.Set("bytes", (double) _bytes);
+    if (_records == 0) {
+        result.Set("lastKey", env.Undefined());
+    } else if (stringKeyMode) {
+        result.Set("lastKey", Napi::String::New(env, _lastKey.data(), _lastKey.size()));
+    } else {
+        result.Set("lastKey", Napi::Buffer<char>::Copy(env, _lastKey.data(), _lastKey.size()));
+    };
+    result.Set("rest", Napi::Buffer<char>::Copy(env, _parameters.data.data(), _parameters.data.size()));
+    result.Set("eof", _eof);
+
+    _deferred.Resolve(result);
+}
+
+void BulkLoadWorker::OnError(const Napi::Error &error) {
+    _release();
+    _deferred.Reject(error.Value());
+}
+
+void BulkLoadWorker::_release() {
+    if (_dbEnvPtr) {
+        _dbEnvPtr->SetBusy(false);
+        _dbEnvPtr.reset();
+    };
+}
+
+void BulkLoadWorker::_load(MDBX_txn *txn) {
+    const MDBX_dbi dbi = _parameters.dbi;
+    int rc = MDBX_SUCCESS;
+
+    // Sorted input is resumed after the last (i.e. the greatest) committed key.
+    if (_parameters.resume) {
+        MDBX_cursor *dbCur = NULL;
+        rc = mdbx_cursor_open(txn, dbi, &dbCur);
+        CheckMdbxResult(rc);
+
+        MDBX_val key;
+        rc = mdbx_cursor_get(dbCur, &key, NULL, MDBX_LAST);
+        if (rc == MDBX_SUCCESS) {
+            const char *data = (const char *) key.iov_base;
+            _resumeKey.assign(data, data + key.iov_len);
+            _hasResumeKey = true;
+        };
+        mdbx_cursor_close(dbCur);
+        if (rc != MDBX_NOTFOUND)
+            CheckMdbxResult(rc);
+    };
+
+    const MDBX_val resumeKey = CreateMdbxVal(_resumeKey);
+    const MDBX_put_flags_t putFlags = _parameters.sorted ? MDBX_APPEND : MDBX_UPSERT;
+    buffer_t &data = _parameters.data;
+    size_t offset = 0;
+
+    for (;;) {
+        MDBX_val key;
+        MDBX_val value;
+        if (!_parseRecord(offset, key, value)) {
+            data.erase(data.begin(), data.begin() + offset);
+            offset = 0;
+            if (_bytes >= _parameters.txnBytes || !_readInput())
+                break;
+            continue;
+        };
+
+        if (_hasResumeKey && mdbx_cmp(txn, dbi, &key, &resumeKey) <= 0) {
+            _skipped++;
+            continue;
+        };
+
+        MDBX_val storedValue = value;
+        if (_parameters.dbiParameters.compression != Compression::none) {
+            const char *valueData = (const char *) value.iov_base;
+            _valueBuffer.assign(valueData, valueData + value.iov_len);
+            storedValue = CompressValue(
+                _parameters.dbiParameters.compression,
+                _parameters.dbiParameters.compressionThreshold,
+                _valueBuffer,
+                _compressedBuffer
+            );
+        };
+
+        rc = mdbx_put(txn, dbi, &key, &storedValue, putFlags);
+        CheckMdbxResult(rc);
+
+        _records++;
+        _bytes += key.iov_len + value.iov_len;
+        const char *keyData = (const char *) key.iov_base;
+        _lastKey.assign(keyData, keyData + key.iov_len);
+
+        if (_bytes >= _parameters.txnBytes) {
+            data.erase(data.begin(), data.begin() + offset);
+            break;
+        };
+    };
+}
+
+bool BulkLoadWorker::_parseRecord(size_t &offset, MDBX_val &key, MDBX_val &value) {
+    buffer_t &data = _parameters.data;
+
+    if (_parameters.format == BulkRecordFormat::lengthPrefixed) {
+        const size_t available = data.size() - offset;
+        const char *record = data.data() + offset;
+        if (available < sizeof(uint32_t))
+            return false;
+        const size_t keyLength = ReadUint32LE(record);
+        if (available < 2 * sizeof(uint32_t) + keyLength)
+            return false;
+        const size_t valueLength = ReadUint32LE(record + sizeof(uint32_t) + keyLength);
+        if (available < 2 * sizeof(uint32_t) + keyLength + valueLength)
+            return false;
+
+        key.iov_base = (void *) (record + sizeof(uint32_t));
+        key.iov_len = keyLength;
+        value.iov_base = (void *) (record + 2 * sizeof(uint32_t) + keyLength);
+        value.iov_len = valueLength;
+        offset += 2 * sizeof(uint32_t) + keyLength + valueLength;
+        return true;
+    };
+
+    for (;;) {
+        const char *line = data.data() + offset;
+        const char *lineEnd = (const char *) std::memchr(line, '\n', data.size() - offset);
+        if (lineEnd == NULL)
+            return false;
+        offset = lineEnd - data.data() + 1;
+
+        if (lineEnd > line && lineEnd[-1] == '\r')
+            lineEnd--;
+        if (lineEnd == line)
+            continue;
+
+        const char *separator = (const char *) std::memchr(line, '\t', lineEnd - line);
+        if (separator == NULL)
+            throw DbException("Malformed record: no tab between key and value.");
+
+        key.iov_base = (void *) line;
+        key.iov_len = separator - line;
+        value.iov_base = (void *) (separator + 1);
+        value.iov_len = lineEnd - separator - 1;
+        return true;
+    };
+}
+
+bool BulkLoadWorker::_readInput() {
+    buffer_t &data = _parameters.data;
+
+    if (_parameters.fd >= 0 && !_eof) {
+        const size_t size = data.size();
+        data.resize(size + READ_CHUNK_SIZE);
+#ifdef _WIN32
+        const int bytesRead = _read(_parameters.fd, data.data() + size, (unsigned) READ_CHUNK_SIZE);
+#else
+        ssize_t bytesRead;
+        do {
+            bytesRead = read(_parameters.fd, data.data() + size, READ_CHUNK_SIZE);
+        } while (bytesRead < 0 && errno == EINTR);
+#endif
+        if (bytesRead < 0) {
+            data.resize(size);
+            throw DbException(std::string("Can't read bulk load input: ") + std::strerror(errno));
+        };
+        data.resize(size + bytesRead);
+        if (bytesRead > 0)
+            return true;
+        _eof = true;
+    };
+
+    // Input is over: the last line may lack its line feed, but length-prefixed records can't be partial.
+    if (!_parameters.last && !_eof)
+        return false;
+    if (data.empty())
+        return false;
+    if (_parameters.format == BulkRecordFormat::lines && data.back() != '\n') {
+        data.push_back('\n');
+        return true;
+    };
+    throw DbException("Truncated record at the end of bulk load input.");
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <napi.h>
+#include "mdbx.h"
+
+#include "db_env.h"
+#include "utils.h"
+
+enum class BulkRecordFormat {
+    lengthPrefixed = 0,
+    lines
+};
+
+struct BulkLoadParameters {
+    MDBX_dbi dbi = 0;
+    DbiParameters dbiParameters;
+    BulkRecordFormat format = BulkRecordFormat::lengthPrefixed;
+    bool sorted = false;
+    bool resume = false;
+    size_t txnBytes = 64 * MB;
+    // Records source: either file descriptor (read on the worker thread) or data passed from JS.
+    int fd = -1;
+    buffer_t data;
+    // No more data follows this batch.
+    bool last = false;
+};
+
+// Loads one batch of records within one write transaction on a worker thread.
+// Unparsed tail of the input (partial record) is returned to be passed with the next batch.
+class BulkLoadWorker : public Napi::AsyncWorker {
+public:
+    BulkLoadWorker(Napi::Env env, const DbEnvPtr &dbEnvPtr, BulkLoadParameters &&parameters);
+    ~BulkLoadWorker();
+
+    Napi::Promise GetPromise();
+
+protected:
+    void Execute() override;
+    void OnOK() override;
+    void OnError(const Napi::Error &error) override;
+
+private:
+    void _load(MDBX_txn *txn);
+    bool _parseRecord(size_t &offset, MDBX_val &key, MDBX_val &value);
+    bool _readInput();
+    void _release();
+
+    DbEnvPtr _dbEnvPtr;
+    MDBX_env *_env = NULL;
+    BulkLoadParameters _parameters;
+    Napi::Promise::Deferred _deferred;
+
+    buffer_t _resumeKey;
+    bool _hasResumeKey = false;
+    buffer_t _valueBuffer;
+    buffer_t _compressedBuffer;
+
+    uint64_t _records = 0;
+    uint64_t _skipped = 0;
+    uint64_t _bytes = 0;
+    buffer_t _lastKey;
+    bool _eof = false;
+};
@@ -0,0 +1,66 @@
+#include "compact_worker.h"
+
+CompactWorker::CompactWorker(Napi::Env env, const DbEnvPtr &dbEnvPtr, const std::string &target):
+    Napi::AsyncWorker(env),
+    _dbEnvPtr(dbEnvPtr),
+    _target(target),
+    _deferred(Napi::Promise::Deferred::New(env))
+{
+    if (_dbEnvPtr->IsBusy())
+        throw Napi::Error::New(env, "Database is busy with a background operation.");
+    _env = _dbEnvPtr->GetEnv();
+    _dbEnvPtr->AddBackgroundReader();
+}
+
+CompactWorker::~CompactWorker() {
+    _release();
+}
+
+Napi::Promise CompactWorker::GetPromise() {
+    return _deferred.Promise();
+}
+
+void CompactWorker::Execute() {
+    try {
+        MDBX_envinfo info;
+        int rc = mdbx_env_info_ex(_env, NULL, &info, sizeof(info));
+        CheckMdbxResult(rc);
+        _txnId = info.mi_recent_txnid;
+        _sourceBytes = info.mi_geo.current;
+
+        rc = mdbx_env_copy(_env, _target.c_str(), MDBX_CP_COMPACT);
+        CheckMdbxResult(rc);
+
+        // Snapshot of the copy is not older than _txnId, so the same id afterwards means it is exactly that one.
+        rc = mdbx_env_info_ex(_env, NULL, &info, sizeof(info));
+        CheckMdbxResult(rc);
+        _modified = info.mi_recent_txnid != _txnId;
+        _targetBytes = GetFileSize(_target);
+    } catch(std::exception &e) {
+        SetError(e.what());
+    };
+}
+
+void CompactWorker::OnOK() {
+    Napi::Env env = Env();
+    _release();
+
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("txnId", (double) _txnId);
+    result.Set("modified", _modified);
+    result.Set("sourceBytes", (double) _sourceBytes);
+    result.Set("targetBytes", (double) _targetBytes);
+    _deferred.Resolve(result);
+}
+
+void CompactWorker::OnError(const Napi::Error &error) {
+    _release();
+    _deferred.Reject(error.Value());
+}
+
+void CompactWorker::_release() {
+    if (_dbEnvPtr) {
+        _dbEnvPtr->ReleaseBackgroundReader();
+        _dbEnvPtr.reset();
+    };
+}
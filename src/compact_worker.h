@@ -0,0 +1,35 @@
+#pragma once
+
+#include <napi.h>
+#include "mdbx.h"
+
+#include "db_env.h"
+
+// Writes compacted copy of the database (mdbx_env_copy with MDBX_CP_COMPACT) into a new file
+// on a worker thread. Copy is made from a read snapshot, so transactions may run meanwhile;
+// the result tells whether the database has been modified during the copy.
+class CompactWorker : public Napi::AsyncWorker {
+public:
+    CompactWorker(Napi::Env env, const DbEnvPtr &dbEnvPtr, const std::string &target);
+    ~CompactWorker();
+
+    Napi::Promise GetPromise();
+
+protected:
+    void Execute() override;
+    void OnOK() override;
+    void OnError(const Napi::Error &error) override;
+
+private:
+    void _release();
+
+    DbEnvPtr _dbEnvPtr;
+    MDBX_env *_env = NULL;
+    std::string _target;
+    Napi::Promise::Deferred _deferred;
+
+    uint64_t _txnId = 0;
+    bool _modified = false;
+    uint64_t _sourceBytes = 0;
+    uint64_t _targetBytes = 0;
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "mdbx.h"
+
+// Custom key comparators are not known to MDBX itself, so they are recorded in this service dbi (by dbi name).
+// It also records 'buffer' dbis created with compression (by dbi name followed by COMPRESSION_RECORD_SUFFIX).
+static const char *const KEY_COMPARATORS_DBI = "__node_mdbx_key_comparators";
+// Dbi names can't contain zero bytes, so such records never clash with comparator ones.
+static const char COMPRESSION_RECORD_SUFFIX[] = "\0compression";
+
+enum class KeyComparator {
+    none = 0,
+    lengthFirst,
+    asciiCaseInsensitive
+};
+
+// Comparators are instantiated per kind at compile time, so MDBX calls straight into specialized code.
+template<KeyComparator C>
+int CompareKeys(const MDBX_val *a, const MDBX_val *b) MDBX_CXX17_NOEXCEPT;
+
+template<>
+inline int CompareKeys<KeyComparator::lengthFirst>(const MDBX_val *a, const MDBX_val *b) MDBX_CXX17_NOEXCEPT {
+    if (a->iov_len != b->iov_len)
+        return a->iov_len < b->iov_len ? -1 : 1;
+    return a->iov_len ? std::memcmp(a->iov_base, b->iov_base, a->iov_len) : 0;
+}
+
+template<>
+inline int CompareKeys<KeyComparator::asciiCaseInsensitive>(const MDBX_val *a, const MDBX_val *b) MDBX_CXX17_NOEXCEPT {
+    const uint8_t *aBytes = (const uint8_t *) a->iov_base;
+    const uint8_t *bBytes = (const uint8_t *) b->iov_base;
+    const size_t length = a->iov_len < b->iov_len ? a->iov_len : b->iov_len;
+    for (size_t i = 0; i < length; i++) {
+        uint8_t aByte = aBytes[i];
+        uint8_t bByte = bBytes[i];
+        if (aByte >= 'A' && aByte <= 'Z')
+            aByte += 'a' - 'A';
+        if (bByte >= 'A' && bByte <= 'Z')
+            bByte += 'a' - 'A';
+        if (aByte != bByte)
+            return aByte < bByte ? -1 : 1;
+    };
+    return a->iov_len < b->iov_len ? -1 : (a->iov_len > b->iov_len ? 1 : 0);
+}
+
+static MDBX_cmp_func * GetKeyComparatorFunction(KeyComparator keyComparator) {
+    switch (keyComparator) {
+        case KeyComparator::lengthFirst: return &CompareKeys<KeyComparator::lengthFirst>;
+        case KeyComparator::asciiCaseInsensitive: return &CompareKeys<KeyComparator::asciiCaseInsensitive>;
+        default: return NULL;
+    };
+}
+
+// Comparator actually used by dbi: custom one or built-in mdbx comparator for given flags.
+static MDBX_cmp_func * GetDbiKeyComparatorFunction(KeyComparator keyComparator, bool reverseKey) {
+    MDBX_cmp_func *function = GetKeyComparatorFunction(keyComparator);
+    if (function != NULL)
+        return function;
+    return mdbx_get_keycmp(reverseKey ? MDBX_REVERSEKEY : MDBX_DB_DEFAULTS);
+}
+
+static const char * GetKeyComparatorName(KeyComparator keyComparator) {
+    switch (keyComparator) {
+        case KeyComparator::lengthFirst: return "lengthFirst";
+        case KeyComparator::asciiCaseInsensitive: return "asciiCaseInsensitive";
+        default: return "default";
+    };
+}
+
+static bool FindKeyComparator(const std::string &name, KeyComparator &keyComparator) {
+    static const KeyComparator comparators[] = {
+        KeyComparator::none, KeyComparator::lengthFirst, KeyComparator::asciiCaseInsensitive,
+    };
+    for (const KeyComparator comparator : comparators) {
+        if (name == GetKeyComparatorName(comparator)) {
+            keyComparator = comparator;
+            return true;
+        };
+    };
+    return false;
+}
@@ -0,0 +1,96 @@
+#include "compression.h"
+#include "db_exception.h"
+#include "lz4.h"
+
+#include <cstring>
+
+namespace {
+
+enum Method: uint8_t {
+    METHOD_STORED = 0,
+    METHOD_LZ4 = 1
+};
+
+const size_t HEADER_SIZE = 2;
+const size_t LZ4_HEADER_SIZE = HEADER_SIZE + sizeof(uint32_t);
+
+void WriteHeader(buffer_t &to, Method method) {
+    to.clear();
+    to.push_back((char) COMPRESSION_MARKER);
+    to.push_back((char) method);
+}
+
+uint32_t ReadUint32LE(const uint8_t *bytes) {
+    return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((uint32_t) bytes[3] << 24);
+}
+
+[[noreturn]] void ThrowMalformed() {
+    throw DbException("Malformed compressed value.");
+}
+
+}
+
+MDBX_val CompressValue(Compression compression, size_t threshold, const buffer_t &value, buffer_t &scratch) {
+    const bool hasMarker = !value.empty() && (uint8_t) value[0] == COMPRESSION_MARKER;
+
+    const bool worthCompressing = value.size() >= threshold && value.size() > LZ4_HEADER_SIZE + 16 && value.size() <= UINT32_MAX;
+    if (compression == Compression::lz4 && worthCompressing) {
+        // Compressed value is kept only if it saves at least 1/16 of the space.
+        const size_t limit = value.size() - value.size() / 16 - LZ4_HEADER_SIZE;
+        scratch.resize(LZ4_HEADER_SIZE + limit);
+        const size_t compressedSize = Lz4Compress(value.data(), value.size(), scratch.data() + LZ4_HEADER_SIZE, limit);
+        if (compressedSize != 0) {
+            const uint32_t size = (uint32_t) value.size();
+            scratch[0] = (char) COMPRESSION_MARKER;
+            scratch[1] = (char) METHOD_LZ4;
+            for (size_t i = 0; i < sizeof(size); i++)
+                scratch[HEADER_SIZE + i] = (char) (size >> (i * 8));
+            scratch.resize(LZ4_HEADER_SIZE + compressedSize);
+            return CreateMdbxVal(scratch);
+        };
+    };
+
+    if (hasMarker) {
+        WriteHeader(scratch, METHOD_STORED);
+        scratch.insert(scratch.end(), value.begin(), value.end());
+        return CreateMdbxVal(scratch);
+    };
+
+    return CreateMdbxVal(value);
+}
+
+bool IsCompressedValue(const MDBX_val &value) {
+    return value.iov_len > 0 && *(const uint8_t *) value.iov_base == COMPRESSION_MARKER;
+}
+
+size_t GetDecompressedSize(const MDBX_val &value) {
+    const uint8_t *data = (const uint8_t *) value.iov_base;
+    if (value.iov_len < HEADER_SIZE)
+        ThrowMalformed();
+
+    switch (data[1]) {
+        case METHOD_STORED:
+            return value.iov_len - HEADER_SIZE;
+        case METHOD_LZ4:
+            if (value.iov_len < LZ4_HEADER_SIZE)
+                ThrowMalformed();
+            return ReadUint32LE(data + HEADER_SIZE);
+        default:
+            ThrowMalformed();
+    };
+}
+
+void DecompressValue(const MDBX_val &value, char *to, size_t size) {
+    const uint8_t *data = (const uint8_t *) value.iov_base;
+    if (GetDecompressedSize(value) != size)
+        ThrowMalformed();
+
+    if (data[1] == METHOD_STORED) {
+        if (size != 0)
+            std::memcpy(to, data + HEADER_SIZE, size);
+        return;
+    };
+
+    if (!Lz4Decompress((const char *) data + LZ4_HEADER_SIZE, value.iov_len - LZ4_HEADER_SIZE, to, size))
+        ThrowMalformed();
+}
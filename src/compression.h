@@ -0,0 +1,23 @@
+#pragma once
+
+#include "mdbx.h"
+#include "utils.h"
+
+enum class Compression {
+    none = 0,
+    lz4
+};
+
+// Values of compressed dbis are stored as is, unless compressed (or starting with the marker byte).
+// In the latter case they have a header: [marker][method][payload].
+// Marker never starts valid UTF-8 and MessagePack data, so values of 'string' and 'msgpack' dbis written before compression
+// had been enabled are still readable. Raw buffers written before that could start with the marker, so compression
+// is enabled only for empty 'buffer' dbis (see DbEnv::_checkCompression).
+const uint8_t COMPRESSION_MARKER = 0xc1;
+
+// Returns value to be stored: either 'value' itself or compressed data placed into 'scratch'.
+MDBX_val CompressValue(Compression compression, size_t threshold, const buffer_t &value, buffer_t &scratch);
+
+bool IsCompressedValue(const MDBX_val &value);
+size_t GetDecompressedSize(const MDBX_val &value);
+void DecompressValue(const MDBX_val &value, char *to, size_t size);
@@ -1,16 +1,36 @@
 #include "cpp_dbi.h"
+#include "msgpack.h"
 #include "utils.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Number.MAX_SAFE_INTEGER
+static const int64_t MAX_SAFE_INTEGER = 9007199254740991;
+
 CppDbi::CppDbi(const Napi::CallbackInfo & info): Napi::ObjectWrap<CppDbi>(info) {};
 
 Napi::Function CppDbi::GetClass(Napi::Env env) {
     return DefineClass(env, "CppDbi", {
         CppDbi::InstanceMethod("isStale", &CppDbi::IsStale),
+        CppDbi::InstanceMethod("internStats", &CppDbi::InternStats),
 
         CppDbi::InstanceMethod("put", &CppDbi::Put),
+        CppDbi::InstanceMethod("putReserve", &CppDbi::PutReserve),
         CppDbi::InstanceMethod("get", &CppDbi::Get),
+        CppDbi::InstanceMethod("getSlice", &CppDbi::GetSlice),
         CppDbi::InstanceMethod("del", &CppDbi::Del),
         CppDbi::InstanceMethod("has", &CppDbi::Has),
+        CppDbi::InstanceMethod("delRange", &CppDbi::DelRange),
+
+        CppDbi::InstanceMethod("increment", &CppDbi::Increment),
+        CppDbi::InstanceMethod("putIfAbsent", &CppDbi::PutIfAbsent),
+        CppDbi::InstanceMethod("compareAndSwap", &CppDbi::CompareAndSwap),
+        CppDbi::InstanceMethod("take", &CppDbi::Take),
+
+        CppDbi::InstanceMethod("sequence", &CppDbi::Sequence),
+        CppDbi::InstanceMethod("putAutoId", &CppDbi::PutAutoId),
 
         CppDbi::InstanceMethod("first", &CppDbi::FirstKey),
         CppDbi::InstanceMethod("last", &CppDbi::LastKey),
@@ -20,10 +40,26 @@ Napi::Function CppDbi::GetClass(Napi::Env env) {
     });
 }
 
-void CppDbi::Init(const DbEnvPtr &dbEnvPtr, MDBX_dbi dbDbi, const std::string &name) {
+void CppDbi::Init(const DbEnvPtr &dbEnvPtr, const DbiInfo &dbiInfo, const std::string &name,
+    const KeyInternCachePtr &keyInternCache, const ReservedBuffersPtr &reservedBuffers)
+{
     _dbEnvPtr = dbEnvPtr;
-    _dbDbi = dbDbi;
+    _dbDbi = dbiInfo.dbi;
+    _parameters = dbiInfo.parameters;
+    _keyCmp = GetDbiKeyComparatorFunction(_parameters.keyComparator, _parameters.reverseKey);
     _name = name;
+    _keyInternCache = keyInternCache;
+    _reservedBuffers = reservedBuffers;
+    LatencyStats &latencyStats = _dbEnvPtr->GetLatencyStats();
+    _latency = latencyStats.IsEnabled() ? latencyStats.GetDbiLatency(name) : NULL;
+}
+
+MDBX_dbi CppDbi::GetDbi() {
+    return _dbDbi;
+}
+
+const DbiParameters & CppDbi::GetParameters() {
+    return _parameters;
 }
 
 Napi::Value CppDbi::IsStale(const Napi::CallbackInfo& info) {
@@ -36,29 +72,89 @@ Napi::Value CppDbi::IsStale(const Napi::CallbackInfo& info) {
     return Napi::Value::From(env, isStale);
 }
 
+Napi::Value CppDbi::InternStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (!_keyInternCache)
+        return env.Undefined();
+
+    const KeyInternCache::Stats &stats = _keyInternCache->GetStats();
+    const uint64_t lookups = stats.hits + stats.misses;
+
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("hits", (double) stats.hits);
+    result.Set("misses", (double) stats.misses);
+    result.Set("hitRate", lookups ? (double) stats.hits / lookups : 0.0);
+    result.Set("evictions", (double) stats.evictions);
+    result.Set("size", (double) stats.size);
+    result.Set("capacity", (double) stats.capacity);
+    return result;
+}
+
 Napi::Value CppDbi::Put(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
 
     _check(env);
+    LatencyTimer timer(_dbEnvPtr->GetLatencyStats(), _latency, LatencyOp::put);
+    _beforeWrite();
 
     ExtractBuffer(info[0], _keyBuffer);
-    ExtractBuffer(info[1], _valueBuffer);
+    MDBX_val value = _inValue(info[1]);
 
     return wrapException(env, [&] () {
         MDBX_val key = CreateMdbxVal(_keyBuffer);
-        MDBX_val value = CreateMdbxVal(_valueBuffer);
+
+        if (_dbEnvPtr->IsWriteBuffered()) {
+            _dbEnvPtr->BufferWrite(_dbDbi, _keyCmp, key, &value);
+            return env.Undefined();
+        };
 
         const int rc = mdbx_put(_dbEnvPtr->GetTransaction(), _dbDbi, &key, &value, MDBX_UPSERT);
         CheckMdbxResult(rc);
 
+        _dbEnvPtr->AfterWrite();
+
         return env.Undefined();
     });
 }
 
+Napi::Value CppDbi::PutReserve(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    _check(env);
+    LatencyTimer timer(_dbEnvPtr->GetLatencyStats(), _latency, LatencyOp::put);
+    _beforeWrite();
+
+    if (_parameters.valueMode == ValueMode::msgpack || _parameters.compression != Compression::none)
+        throw Napi::Error::New(env, "putReserve is not supported for dbis with msgpack valueMode or compression.");
+
+    ExtractBuffer(info[0], _keyBuffer);
+
+    if (!info[1].IsNumber() || !(info[1].ToNumber().DoubleValue() >= 0))
+        throw Napi::Error::New(env, "Wrong size; should be a non-negative number.");
+    const size_t size = (size_t) info[1].ToNumber().DoubleValue();
+
+    return wrapException(env, [&] () -> Napi::Value {
+        _flushWriteBuffer();
+
+        MDBX_val key = CreateMdbxVal(_keyBuffer);
+        MDBX_val value;
+        value.iov_base = NULL;
+        value.iov_len = size;
+
+        const int rc = mdbx_put(_dbEnvPtr->GetTransaction(), _dbDbi, &key, &value, MDBX_UPSERT | MDBX_RESERVE);
+        CheckMdbxResult(rc);
+
+        // No auto-split here: the reserved space should be filled before the transaction is committed.
+        return _reservedBuffers->Create(env, value);
+    });
+}
+
 Napi::Value CppDbi::Get(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
 
     _check(env);
+    LatencyTimer timer(_dbEnvPtr->GetLatencyStats(), _latency, LatencyOp::get);
 
     ExtractBuffer(info[0], _keyBuffer);
 
@@ -66,14 +162,63 @@ Napi::Value CppDbi::Get(const Napi::CallbackInfo& info) {
         MDBX_val key = CreateMdbxVal(_keyBuffer);
         MDBX_val value;
 
+        if (_isServiceKey(key))
+            return env.Undefined();
+
+        const WriteBuffer::Value *buffered = _dbEnvPtr->FindBufferedWrite(_dbDbi, key);
+        if (buffered != NULL) {
+            if (buffered->deleted)
+                return env.Undefined();
+            value.iov_base = (void *) buffered->data.data();
+            value.iov_len = buffered->data.size();
+            return _outValue(env, value);
+        };
+
         const int rc = mdbx_get(_dbEnvPtr->GetTransaction(), _dbDbi, &key, &value);
         if (rc == MDBX_NOTFOUND)
             return env.Undefined();
         CheckMdbxResult(rc);
 
-        Napi::Buffer<char> result = Napi::Buffer<char>::Copy(env, (const char *)value.iov_base, value.iov_len);
+        return _outValue(env, value);
+    });
+}
+
+Napi::Value CppDbi::GetSlice(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    _check(env);
+    LatencyTimer timer(_dbEnvPtr->GetLatencyStats(), _latency, LatencyOp::get);
+
+    if (_parameters.valueMode == ValueMode::msgpack || _parameters.compression != Compression::none)
+        throw Napi::Error::New(env, "getSlice is not supported for dbis with msgpack valueMode or compression.");
+
+    ExtractBuffer(info[0], _keyBuffer);
+
+    if (!info[1].IsNumber() || !(info[1].ToNumber().DoubleValue() >= 0))
+        throw Napi::Error::New(env, "Wrong offset; should be a non-negative number.");
+    const size_t offset = (size_t) info[1].ToNumber().DoubleValue();
+
+    if (!info[2].IsNumber() || !(info[2].ToNumber().DoubleValue() >= 0))
+        throw Napi::Error::New(env, "Wrong length; should be a non-negative number.");
+    const size_t length = (size_t) info[2].ToNumber().DoubleValue();
+
+    return wrapException(env, [&] () -> Napi::Value {
+        _flushWriteBuffer();
+
+        MDBX_val key = CreateMdbxVal(_keyBuffer);
+        MDBX_val value;
+        if (_isServiceKey(key))
+            return env.Undefined();
+
+        const int rc = mdbx_get(_dbEnvPtr->GetTransaction(), _dbDbi, &key, &value);
+        if (rc == MDBX_NOTFOUND)
+            return env.Undefined();
+        CheckMdbxResult(rc);
 
-        return _outValue(result);
+        // Large values are contiguous in the mapped overflow pages, so only the slice is copied.
+        const size_t start = std::min(offset, value.iov_len);
+        const size_t size = std::min(length, value.iov_len - start);
+        return Napi::Buffer<char>::Copy(env, (const char *) value.iov_base + start, size);
     });
 }
 
@@ -81,17 +226,39 @@ Napi::Value CppDbi::Del(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
 
     _check(env);
+    LatencyTimer timer(_dbEnvPtr->GetLatencyStats(), _latency, LatencyOp::del);
+    _beforeWrite();
 
     ExtractBuffer(info[0], _keyBuffer);
 
     return wrapException(env, [&] () {
         MDBX_val key = CreateMdbxVal(_keyBuffer);
 
+        if (_dbEnvPtr->IsWriteBuffered()) {
+            // Result needs existence of the key, which is cheaper to check than to dirty its page.
+            bool exists = false;
+            const WriteBuffer::Value *buffered = _dbEnvPtr->FindBufferedWrite(_dbDbi, key);
+            if (buffered != NULL) {
+                exists = !buffered->deleted;
+            } else {
+                MDBX_val value;
+                const int rc = mdbx_get(_dbEnvPtr->GetTransaction(), _dbDbi, &key, &value);
+                if (rc != MDBX_NOTFOUND)
+                    CheckMdbxResult(rc);
+                exists = rc == MDBX_SUCCESS;
+            };
+            if (exists)
+                _dbEnvPtr->BufferWrite(_dbDbi, _keyCmp, key, NULL);
+            return Napi::Value::From(env, exists);
+        };
+
         const int rc = mdbx_del(_dbEnvPtr->GetTransaction(), _dbDbi, &key, NULL);
         if (rc == MDBX_NOTFOUND)
             return Napi::Value::From(env, false);
         CheckMdbxResult(rc);
 
+        _dbEnvPtr->AfterWrite();
+
         return Napi::Value::From(env, true);
     });
 }
@@ -100,12 +267,19 @@ Napi::Value CppDbi::Has(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
 
     _check(env);
+    LatencyTimer timer(_dbEnvPtr->GetLatencyStats(), _latency, LatencyOp::has);
 
     ExtractBuffer(info[0], _keyBuffer);
 
     return wrapException(env, [&] () {
         MDBX_val key = CreateMdbxVal(_keyBuffer);
         MDBX_val value;
+        if (_isServiceKey(key))
+            return Napi::Value::From(env, false);
+
+        const WriteBuffer::Value *buffered = _dbEnvPtr->FindBufferedWrite(_dbDbi, key);
+        if (buffered != NULL)
+            return Napi::Value::From(env, !buffered->deleted);
 
         const int rc = mdbx_get(_dbEnvPtr->GetTransaction(), _dbDbi, &key, &value);
         if (rc == MDBX_NOTFOUND)
@@ -116,12 +290,450 @@ Napi::Value CppDbi::Has(const Napi::CallbackInfo& info) {
     });
 }
 
+// How many deletions are made between checks of the transaction auto-split threshold.
+static const uint64_t DEL_RANGE_SPLIT_CHECK_INTERVAL = 256;
+
+Napi::Value CppDbi::DelRange(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    _check(env);
+    LatencyTimer timer(_dbEnvPtr->GetLatencyStats(), _latency, LatencyOp::delRange);
+    _beforeWrite();
+
+    bool hasGte = false;
+    bool hasLt = false;
+    buffer_t ltBuffer;
+    uint64_t limit = UINT64_MAX;
+    if (info[0].IsObject()) {
+        Napi::Object options = info[0].ToObject();
+
+        Napi::Value gte = options.Get("gte");
+        if (!gte.IsUndefined() && !gte.IsNull()) {
+            ExtractBuffer(gte, _keyBuffer);
+            hasGte = true;
+        };
+
+        Napi::Value lt = options.Get("lt");
+        if (!lt.IsUndefined() && !lt.IsNull()) {
+            ExtractBuffer(lt, ltBuffer);
+            hasLt = true;
+        };
+
+        Napi::Value limitValue = options.Get("limit");
+        if (!limitValue.IsUndefined() && !limitValue.IsNull()) {
+            if (!limitValue.IsNumber() || !(limitValue.ToNumber().DoubleValue() >= 0))
+                throw Napi::Error::New(env, "Wrong limit; should be a non-negative number.");
+            limit = (uint64_t) limitValue.ToNumber().DoubleValue();
+        };
+    } else if (!info[0].IsUndefined() && !info[0].IsNull()) {
+        throw Napi::Error::New(env, "Wrong range; should be an object {gte, lt, limit}.");
+    };
+
+    return wrapException(env, [&] () {
+        _flushWriteBuffer();
+
+        MDBX_val gteKey = CreateMdbxVal(_keyBuffer);
+        MDBX_val ltKey = CreateMdbxVal(ltBuffer);
+        MDBX_cursor *dbCur = NULL;
+        MDBX_val key;
+        uint64_t count = 0;
+
+        int rc = MDBX_SUCCESS;
+        try {
+            rc = mdbx_cursor_open(_dbEnvPtr->GetTransaction(), _dbDbi, &dbCur);
+            CheckMdbxResult(rc);
+
+            MDBX_stat stat;
+            if (limit != 0 && _isWholeRange(dbCur, hasGte ? &gteKey : NULL, hasLt ? &ltKey : NULL, limit)) {
+                rc = mdbx_dbi_stat(_dbEnvPtr->GetTransaction(), _dbDbi, &stat, sizeof(stat));
+                CheckMdbxResult(rc);
+                mdbx_cursor_close(dbCur);
+                dbCur = NULL;
+
+                rc = mdbx_drop(_dbEnvPtr->GetTransaction(), _dbDbi, false);
+                CheckMdbxResult(rc);
+                _dbEnvPtr->AfterWrite();
+
+                return Napi::Value::From(env, (double) stat.ms_entries);
+            };
+
+            key = gteKey;
+            rc = mdbx_cursor_get(dbCur, &key, NULL, hasGte ? MDBX_SET_RANGE : MDBX_FIRST);
+            while (rc == MDBX_SUCCESS && count < limit) {
+                if (hasLt && mdbx_cmp(_dbEnvPtr->GetTransaction(), _dbDbi, &key, &ltKey) >= 0)
+                    break;
+
+                rc = mdbx_cursor_del(dbCur, MDBX_CURRENT);
+                CheckMdbxResult(rc);
+                count++;
+
+                // Deleted entry doesn't invalidate the cursor; MDBX_NEXT returns the following one
+                // (or MDBX_ENODATA if the last entry has been deleted).
+                rc = mdbx_cursor_get(dbCur, &key, NULL, MDBX_NEXT);
+                if (rc == MDBX_ENODATA)
+                    rc = MDBX_NOTFOUND;
+                if (rc == MDBX_SUCCESS && count % DEL_RANGE_SPLIT_CHECK_INTERVAL == 0 && _dbEnvPtr->NeedsSplit()) {
+                    // Key points into the page of the committed transaction, so it is saved first.
+                    _keyBuffer.assign((const char *) key.iov_base, (const char *) key.iov_base + key.iov_len);
+                    mdbx_cursor_close(dbCur);
+                    dbCur = NULL;
+
+                    _dbEnvPtr->SplitTransaction();
+
+                    rc = mdbx_cursor_open(_dbEnvPtr->GetTransaction(), _dbDbi, &dbCur);
+                    CheckMdbxResult(rc);
+                    key = CreateMdbxVal(_keyBuffer);
+                    rc = mdbx_cursor_get(dbCur, &key, NULL, MDBX_SET_RANGE);
+                };
+            };
+            if (rc != MDBX_NOTFOUND)
+                CheckMdbxResult(rc);
+
+            mdbx_cursor_close(dbCur);
+            dbCur = NULL;
+
+            if (count)
+                _dbEnvPtr->AfterWrite();
+
+            return Napi::Value::From(env, (double) count);
+        } catch(...) {
+            if (dbCur != NULL)
+                mdbx_cursor_close(dbCur);
+            throw;
+        };
+
+        return env.Undefined();
+    });
+}
+
+Napi::Value CppDbi::Increment(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    _check(env);
+    LatencyTimer timer(_dbEnvPtr->GetLatencyStats(), _latency, LatencyOp::update);
+    _beforeWrite();
+
+    if (_parameters.valueMode == ValueMode::msgpack || _parameters.compression != Compression::none)
+        throw Napi::Error::New(env, "Increment is not supported for dbis with msgpack valueMode or compression.");
+
+    ExtractBuffer(info[0], _keyBuffer);
+
+    const bool isBigInt = info[1].IsBigInt();
+    int64_t delta = 1;
+    if (isBigInt) {
+        bool lossless = true;
+        delta = info[1].As<Napi::BigInt>().Int64Value(&lossless);
+        if (!lossless)
+            throw Napi::Error::New(env, "Wrong delta; BigInt is out of int64 range.");
+    } else if (info[1].IsNumber()) {
+        const double value = info[1].ToNumber();
+        // Range is checked before the cast, which is undefined for values out of int64.
+        if (!std::isfinite(value) || std::trunc(value) != value
+            || value < -9223372036854775808.0 || value >= 9223372036854775808.0)
+            throw Napi::Error::New(env, "Wrong delta; should be an integer.");
+        delta = (int64_t) value;
+    } else if (!info[1].IsUndefined()) {
+        throw Napi::Error::New(env, "Wrong delta; should be a number or a BigInt.");
+    };
+
+    return wrapException(env, [&] () {
+        _flushWriteBuffer();
+
+        MDBX_cursor *dbCur = NULL;
+        MDBX_val key = CreateMdbxVal(_keyBuffer);
+        MDBX_val value;
+
+        int rc = MDBX_SUCCESS;
+        try {
+            rc = mdbx_cursor_open(_dbEnvPtr->GetTransaction(), _dbDbi, &dbCur);
+            CheckMdbxResult(rc);
+
+            // Values are int64 little-endian; absent key counts as 0.
+            uint64_t counter = 0;
+            MDBX_put_flags_t flags = MDBX_NOOVERWRITE;
+            rc = mdbx_cursor_get(dbCur, &key, &value, MDBX_SET_KEY);
+            if (rc == MDBX_SUCCESS) {
+                if (value.iov_len != sizeof(counter))
+                    throw DbException("Value is not an 8-byte integer.");
+                const uint8_t *bytes = (const uint8_t *) value.iov_base;
+                for (size_t i = 0; i < sizeof(counter); i++)
+                    counter |= (uint64_t) bytes[i] << (8 * i);
+                flags = MDBX_CURRENT;
+            } else if (rc != MDBX_NOTFOUND) {
+                CheckMdbxResult(rc);
+            };
+
+            // Overflow wraps around.
+            counter += (uint64_t) delta;
+            // Number result would silently lose precision, so the counter is not changed then.
+            if (!isBigInt && ((int64_t) counter > MAX_SAFE_INTEGER || (int64_t) counter < -MAX_SAFE_INTEGER))
+                throw DbException("Counter is out of safe integer range; BigInt delta should be used.");
+
+            uint8_t bytes[sizeof(counter)];
+            for (size_t i = 0; i < sizeof(counter); i++)
+                bytes[i] = (uint8_t) (counter >> (8 * i));
+            key = CreateMdbxVal(_keyBuffer);
+            value.iov_base = bytes;
+            value.iov_len = sizeof(bytes);
+            rc = mdbx_cursor_put(dbCur, &key, &value, flags);
+            CheckMdbxResult(rc);
+
+            mdbx_cursor_close(dbCur);
+            dbCur = NULL;
+
+            _dbEnvPtr->AfterWrite();
+
+            if (isBigInt)
+                return (Napi::Value) Napi::BigInt::New(env, (int64_t) counter);
+            return Napi::Value::From(env, (double) (int64_t) counter);
+        } catch(...) {
+            if (dbCur != NULL)
+                mdbx_cursor_close(dbCur);
+            throw;
+        };
+
+        return env.Undefined();
+    });
+}
+
+Napi::Value CppDbi::PutIfAbsent(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    _check(env);
+    LatencyTimer timer(_dbEnvPtr->GetLatencyStats(), _latency, LatencyOp::put);
+    _beforeWrite();
+
+    ExtractBuffer(info[0], _keyBuffer);
+    MDBX_val value = _inValue(info[1]);
+
+    return wrapException(env, [&] () {
+        _flushWriteBuffer();
+
+        MDBX_val key = CreateMdbxVal(_keyBuffer);
+
+        const int rc = mdbx_put(_dbEnvPtr->GetTransaction(), _dbDbi, &key, &value, MDBX_NOOVERWRITE);
+        if (rc == MDBX_KEYEXIST)
+            return Napi::Value::From(env, false);
+        CheckMdbxResult(rc);
+
+        _dbEnvPtr->AfterWrite();
+
+        return Napi::Value::From(env, true);
+    });
+}
+
+Napi::Value CppDbi::CompareAndSwap(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    _check(env);
+    LatencyTimer timer(_dbEnvPtr->GetLatencyStats(), _latency, LatencyOp::update);
+    _beforeWrite();
+
+    // Values are compared in serialized (but not compressed) form.
+    ExtractBuffer(info[0], _keyBuffer);
+    const bool expectAbsent = info[1].IsUndefined();
+    // Undefined is a storable msgpack value, so it can't mean absence there.
+    if (expectAbsent && _parameters.valueMode == ValueMode::msgpack)
+        throw Napi::Error::New(env, "Wrong expected value; undefined is ambiguous in msgpack valueMode, putIfAbsent should be used.");
+    buffer_t expected;
+    if (!expectAbsent)
+        _encodeValue(info[1], expected);
+    MDBX_val next = _inValue(info[2]);
+
+    return wrapException(env, [&] () {
+        _flushWriteBuffer();
+
+        MDBX_cursor *dbCur = NULL;
+        MDBX_val key = CreateMdbxVal(_keyBuffer);
+        MDBX_val value;
+        buffer_t scratch;
+
+        int rc = MDBX_SUCCESS;
+        try {
+            rc = mdbx_cursor_open(_dbEnvPtr->GetTransaction(), _dbDbi, &dbCur);
+            CheckMdbxResult(rc);
+
+            MDBX_put_flags_t flags = MDBX_NOOVERWRITE;
+            rc = mdbx_cursor_get(dbCur, &key, &value, MDBX_SET_KEY);
+            if (rc == MDBX_SUCCESS) {
+                const MDBX_val plain = _plainValue(value, scratch);
+                const bool matches = !expectAbsent && plain.iov_len == expected.size()
+                    && (plain.iov_len == 0 || memcmp(plain.iov_base, expected.data(), plain.iov_len) == 0);
+                if (!matches) {
+                    mdbx_cursor_close(dbCur);
+                    return Napi::Value::From(env, false);
+                };
+                flags = MDBX_CURRENT;
+            } else if (rc == MDBX_NOTFOUND) {
+                if (!expectAbsent) {
+                    mdbx_cursor_close(dbCur);
+                    return Napi::Value::From(env, false);
+                };
+            } else {
+                CheckMdbxResult(rc);
+            };
+
+            key = CreateMdbxVal(_keyBuffer);
+            rc = mdbx_cursor_put(dbCur, &key, &next, flags);
+            CheckMdbxResult(rc);
+
+            mdbx_cursor_close(dbCur);
+            dbCur = NULL;
+
+            _dbEnvPtr->AfterWrite();
+
+            return Napi::Value::From(env, true);
+        } catch(...) {
+            if (dbCur != NULL)
+                mdbx_cursor_close(dbCur);
+            throw;
+        };
+
+        return env.Undefined();
+    });
+}
+
+Napi::Value CppDbi::Take(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    _check(env);
+    LatencyTimer timer(_dbEnvPtr->GetLatencyStats(), _latency, LatencyOp::update);
+    _beforeWrite();
+
+    ExtractBuffer(info[0], _keyBuffer);
+
+    return wrapException(env, [&] () {
+        _flushWriteBuffer();
+
+        MDBX_cursor *dbCur = NULL;
+        MDBX_val key = CreateMdbxVal(_keyBuffer);
+        MDBX_val value;
+
+        int rc = MDBX_SUCCESS;
+        try {
+            rc = mdbx_cursor_open(_dbEnvPtr->GetTransaction(), _dbDbi, &dbCur);
+            CheckMdbxResult(rc);
+
+            rc = mdbx_cursor_get(dbCur, &key, &value, MDBX_SET_KEY);
+            if (rc == MDBX_NOTFOUND) {
+                mdbx_cursor_close(dbCur);
+                return env.Undefined();
+            };
+            CheckMdbxResult(rc);
+
+            // Value is copied out before its page is modified.
+            Napi::Value result = _outValue(env, value);
+
+            rc = mdbx_cursor_del(dbCur, MDBX_CURRENT);
+            CheckMdbxResult(rc);
+
+            mdbx_cursor_close(dbCur);
+            dbCur = NULL;
+
+            _dbEnvPtr->AfterWrite();
+
+            return result;
+        } catch(...) {
+            if (dbCur != NULL)
+                mdbx_cursor_close(dbCur);
+            throw;
+        };
+
+        return env.Undefined();
+    });
+}
+
+Napi::Value CppDbi::Sequence(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    _check(env);
+    LatencyTimer timer(_dbEnvPtr->GetLatencyStats(), _latency, LatencyOp::update);
+
+    const bool isBigInt = info[0].IsBigInt();
+    uint64_t increment = 0;
+    if (isBigInt) {
+        bool lossless = true;
+        increment = info[0].As<Napi::BigInt>().Uint64Value(&lossless);
+        if (!lossless)
+            throw Napi::Error::New(env, "Wrong increment; BigInt is out of uint64 range.");
+    } else if (!info[0].IsUndefined()) {
+        if (!info[0].IsNumber() || !(info[0].ToNumber().DoubleValue() >= 0))
+            throw Napi::Error::New(env, "Wrong increment; should be a non-negative number or a BigInt.");
+        increment = (uint64_t) std::min(info[0].ToNumber().DoubleValue(), (double) MAX_SAFE_INTEGER + 1);
+    };
+    if (increment != 0)
+        _beforeWrite();
+
+    return wrapException(env, [&] () -> Napi::Value {
+        // Number result would silently lose precision, so the sequence is not changed then.
+        if (!isBigInt) {
+            const uint64_t current = _sequence(0);
+            if (current > (uint64_t) MAX_SAFE_INTEGER || increment > (uint64_t) MAX_SAFE_INTEGER - current)
+                throw DbException("Sequence is out of safe integer range; BigInt increment should be used.");
+        };
+
+        const uint64_t result = _sequence(increment);
+        if (increment != 0)
+            _dbEnvPtr->AfterWrite();
+
+        if (isBigInt)
+            return Napi::BigInt::New(env, result);
+        return Napi::Value::From(env, (double) result);
+    });
+}
+
+Napi::Value CppDbi::PutAutoId(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    _check(env);
+    LatencyTimer timer(_dbEnvPtr->GetLatencyStats(), _latency, LatencyOp::put);
+    _beforeWrite();
+
+    // Keys are appended, so they should be ordered bytewise.
+    if (_parameters.reverseKey || _parameters.keyComparator != KeyComparator::none)
+        throw Napi::Error::New(env, "PutAutoId is not supported for dbis with reverseKey or custom key order.");
+    // Binary keys of ids can't be returned as strings.
+    if (_dbEnvPtr->IsStringKeyMode())
+        throw Napi::Error::New(env, "PutAutoId is not supported in 'string' keyMode.");
+
+    MDBX_val value = _inValue(info[0]);
+
+    return wrapException(env, [&] () {
+        _flushWriteBuffer();
+
+        // Id is returned as a number, so it should stay a safe integer.
+        if (_sequence(0) >= (uint64_t) MAX_SAFE_INTEGER)
+            throw DbException("Sequence is out of safe integer range.");
+        const uint64_t id = _sequence(1) + 1;
+
+        // Big-endian keys of growing ids are always appended to the end of the dbi.
+        uint8_t bytes[sizeof(id)];
+        for (size_t i = 0; i < sizeof(id); i++)
+            bytes[i] = (uint8_t) (id >> (8 * (sizeof(id) - 1 - i)));
+        MDBX_val key;
+        key.iov_base = bytes;
+        key.iov_len = sizeof(bytes);
+
+        const int rc = mdbx_put(_dbEnvPtr->GetTransaction(), _dbDbi, &key, &value, MDBX_APPEND);
+        if (rc == MDBX_EKEYMISMATCH)
+            throw DbException("Dbi contains keys greater than the allocated id.");
+        CheckMdbxResult(rc);
+
+        _dbEnvPtr->AfterWrite();
+
+        return Napi::Value::From(env, (double) id);
+    });
+}
+
 Napi::Value CppDbi::FirstKey(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
 
     _check(env);
+    LatencyTimer timer(_dbEnvPtr->GetLatencyStats(), _latency, LatencyOp::cursor);
 
     return wrapException(env, [&] () {
+        _flushWriteBuffer();
+
         MDBX_cursor *dbCur = NULL;
         MDBX_val key;
 
@@ -130,16 +742,16 @@ Napi::Value CppDbi::FirstKey(const Napi::CallbackInfo& info) {
             rc = mdbx_cursor_open(_dbEnvPtr->GetTransaction(), _dbDbi, &dbCur);
             CheckMdbxResult(rc);
 
-            rc = mdbx_cursor_get(dbCur, &key, NULL, MDBX_FIRST);
+            rc = _cursorGet(dbCur, &key, MDBX_FIRST);
             if (rc == MDBX_NOTFOUND)
                 return env.Undefined();
             CheckMdbxResult(rc);
 
-            Napi::Buffer<char> result = Napi::Buffer<char>::Copy(env, (const char *)key.iov_base, key.iov_len);
+            Napi::Value result = _outKey(env, key);
 
             mdbx_cursor_close(dbCur);
 
-            return _outKey(result);
+            return result;
         } catch(...) {
             if (dbCur != NULL)
                 mdbx_cursor_close(dbCur);
@@ -154,8 +766,11 @@ Napi::Value CppDbi::LastKey(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
 
     _check(env);
+    LatencyTimer timer(_dbEnvPtr->GetLatencyStats(), _latency, LatencyOp::cursor);
 
     return wrapException(env, [&] () {
+        _flushWriteBuffer();
+
         MDBX_cursor *dbCur = NULL;
         MDBX_val key;
 
@@ -164,16 +779,16 @@ Napi::Value CppDbi::LastKey(const Napi::CallbackInfo& info) {
             rc = mdbx_cursor_open(_dbEnvPtr->GetTransaction(), _dbDbi, &dbCur);
             CheckMdbxResult(rc);
 
-            rc = mdbx_cursor_get(dbCur, &key, NULL, MDBX_LAST);
+            rc = _cursorGet(dbCur, &key, MDBX_LAST);
             if (rc == MDBX_NOTFOUND)
                 return env.Undefined();
             CheckMdbxResult(rc);
 
-            Napi::Buffer<char> result = Napi::Buffer<char>::Copy(env, (const char *)key.iov_base, key.iov_len);
+            Napi::Value result = _outKey(env, key);
 
             mdbx_cursor_close(dbCur);
 
-            return _outKey(result);
+            return result;
         } catch(...) {
             if (dbCur != NULL)
                 mdbx_cursor_close(dbCur);
@@ -188,6 +803,7 @@ Napi::Value CppDbi::NextKey(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
 
     _check(env);
+    LatencyTimer timer(_dbEnvPtr->GetLatencyStats(), _latency, LatencyOp::cursor);
     
     if (info[0].IsNull() || info[0].IsUndefined())
         return env.Undefined();
@@ -196,6 +812,8 @@ Napi::Value CppDbi::NextKey(const Napi::CallbackInfo& info) {
     MDBX_val inKey = CreateMdbxVal(_keyBuffer);
 
     return wrapException(env, [&] () {
+        _flushWriteBuffer();
+
         MDBX_cursor *dbCur = NULL;
         MDBX_val key = inKey;
 
@@ -204,24 +822,24 @@ Napi::Value CppDbi::NextKey(const Napi::CallbackInfo& info) {
             rc = mdbx_cursor_open(_dbEnvPtr->GetTransaction(), _dbDbi, &dbCur);
             CheckMdbxResult(rc);
 
-            rc = mdbx_cursor_get(dbCur, &key, NULL, MDBX_SET_RANGE);
+            rc = _cursorGet(dbCur, &key, MDBX_SET_RANGE);
             if (rc == MDBX_NOTFOUND)
                 return env.Undefined();
             CheckMdbxResult(rc);
 
             const int cmpResult = mdbx_cmp(_dbEnvPtr->GetTransaction(), _dbDbi, &inKey, &key);
             if (cmpResult == 0) {
-                rc = mdbx_cursor_get(dbCur, &key, NULL, MDBX_NEXT);
+                rc = _cursorGet(dbCur, &key, MDBX_NEXT);
                 if (rc == MDBX_NOTFOUND)
                     return env.Undefined();
                 CheckMdbxResult(rc);
             };
 
-            Napi::Buffer<char> result = Napi::Buffer<char>::Copy(env, (const char *)key.iov_base, key.iov_len);
+            Napi::Value result = _outKey(env, key);
 
             mdbx_cursor_close(dbCur);
 
-            return _outKey(result);
+            return result;
         } catch(...) {
             if (dbCur != NULL)
                 mdbx_cursor_close(dbCur);
@@ -236,6 +854,7 @@ Napi::Value CppDbi::PrevKey(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
 
     _check(env);
+    LatencyTimer timer(_dbEnvPtr->GetLatencyStats(), _latency, LatencyOp::cursor);
     
     if (info[0].IsNull() || info[0].IsUndefined())
         return env.Undefined();
@@ -244,6 +863,8 @@ Napi::Value CppDbi::PrevKey(const Napi::CallbackInfo& info) {
     MDBX_val inKey = CreateMdbxVal(_keyBuffer);
 
     return wrapException(env, [&] () {
+        _flushWriteBuffer();
+
         MDBX_cursor *dbCur = NULL;
         MDBX_val key = inKey;
 
@@ -252,9 +873,9 @@ Napi::Value CppDbi::PrevKey(const Napi::CallbackInfo& info) {
             rc = mdbx_cursor_open(_dbEnvPtr->GetTransaction(), _dbDbi, &dbCur);
             CheckMdbxResult(rc);
 
-            rc = mdbx_cursor_get(dbCur, &key, NULL, MDBX_SET_RANGE);
+            rc = _cursorGet(dbCur, &key, MDBX_SET_RANGE);
             if (rc == MDBX_NOTFOUND) {
-                rc = mdbx_cursor_get(dbCur, &key, NULL, MDBX_LAST);
+                rc = _cursorGet(dbCur, &key, MDBX_LAST);
                 if (rc == MDBX_NOTFOUND)
                     return env.Undefined();
             };
@@ -262,17 +883,17 @@ Napi::Value CppDbi::PrevKey(const Napi::CallbackInfo& info) {
 
             const int cmpResult = mdbx_cmp(_dbEnvPtr->GetTransaction(), _dbDbi, &inKey, &key);
             if (cmpResult <= 0) {
-                rc = mdbx_cursor_get(dbCur, &key, NULL, MDBX_PREV);
+                rc = _cursorGet(dbCur, &key, MDBX_PREV);
                 if (rc == MDBX_NOTFOUND)
                     return env.Undefined();
                 CheckMdbxResult(rc);
             };
 
-            Napi::Buffer<char> result = Napi::Buffer<char>::Copy(env, (const char *)key.iov_base, key.iov_len);
+            Napi::Value result = _outKey(env, key);
 
             mdbx_cursor_close(dbCur);
 
-            return _outKey(result);
+            return result;
         } catch(...) {
             if (dbCur != NULL)
                 mdbx_cursor_close(dbCur);
@@ -290,11 +911,14 @@ Napi::Value CppDbi::LowerBoundKey(const Napi::CallbackInfo& info) {
         return FirstKey(info);
 
     _check(env);
+    LatencyTimer timer(_dbEnvPtr->GetLatencyStats(), _latency, LatencyOp::cursor);
 
     ExtractBuffer(info[0], _keyBuffer);
     MDBX_val inKey = CreateMdbxVal(_keyBuffer);
 
     return wrapException(env, [&] () {
+        _flushWriteBuffer();
+
         MDBX_cursor *dbCur = NULL;
         MDBX_val key = inKey;
 
@@ -303,15 +927,15 @@ Napi::Value CppDbi::LowerBoundKey(const Napi::CallbackInfo& info) {
             rc = mdbx_cursor_open(_dbEnvPtr->GetTransaction(), _dbDbi, &dbCur);
             CheckMdbxResult(rc);
 
-            rc = mdbx_cursor_get(dbCur, &key, NULL, MDBX_SET_RANGE);
+            rc = _cursorGet(dbCur, &key, MDBX_SET_RANGE);
             if (rc == MDBX_NOTFOUND)
                 return env.Undefined();
             CheckMdbxResult(rc);
 
-            Napi::Buffer<char> result = Napi::Buffer<char>::Copy(env, (const char *)key.iov_base, key.iov_len);
+            Napi::Value result = _outKey(env, key);
 
             mdbx_cursor_close(dbCur);
-            return _outKey(result);
+            return result;
         } catch(...) {
             if (dbCur != NULL)
                 mdbx_cursor_close(dbCur);
@@ -328,14 +952,126 @@ void CppDbi::_check(Napi::Env &env) {
 
 }
 
-Napi::Value CppDbi::_outKey(Napi::Buffer<char> &buffer) {
-    if (_dbEnvPtr->IsStringKeyMode())
-        return buffer.ToString();
-    return buffer;
+// Whole dbi is in range if range bounds are outside of the first and the last keys.
+bool CppDbi::_isWholeRange(MDBX_cursor *dbCur, const MDBX_val *gte, const MDBX_val *lt, uint64_t limit) {
+    MDBX_txn *dbTxn = _dbEnvPtr->GetTransaction();
+    MDBX_val key;
+
+    int rc = mdbx_cursor_get(dbCur, &key, NULL, MDBX_FIRST);
+    if (rc == MDBX_NOTFOUND)
+        return false;
+    CheckMdbxResult(rc);
+    if (gte != NULL && mdbx_cmp(dbTxn, _dbDbi, gte, &key) > 0)
+        return false;
+
+    rc = mdbx_cursor_get(dbCur, &key, NULL, MDBX_LAST);
+    CheckMdbxResult(rc);
+    if (lt != NULL && mdbx_cmp(dbTxn, _dbDbi, lt, &key) <= 0)
+        return false;
+
+    if (limit != UINT64_MAX) {
+        MDBX_stat stat;
+        rc = mdbx_dbi_stat(dbTxn, _dbDbi, &stat, sizeof(stat));
+        CheckMdbxResult(rc);
+        if (stat.ms_entries > limit)
+            return false;
+    };
+
+    return true;
+}
+
+// Returns value of the dbi sequence before the increment.
+uint64_t CppDbi::_sequence(uint64_t increment) {
+    uint64_t result = 0;
+    const int rc = mdbx_dbi_sequence(_dbEnvPtr->GetTransaction(), _dbDbi, &result, increment);
+    if (rc == MDBX_RESULT_TRUE)
+        throw DbException("Sequence overflow.");
+    CheckMdbxResult(rc);
+    return result;
+}
+
+// Record of the service dbi is hidden from the main dbi (see KEY_COMPARATORS_DBI).
+bool CppDbi::_isServiceKey(const MDBX_val &key) {
+    return _name.empty() && key.iov_len == std::strlen(KEY_COMPARATORS_DBI)
+        && std::memcmp(key.iov_base, KEY_COMPARATORS_DBI, key.iov_len) == 0;
 }
 
-Napi::Value CppDbi::_outValue(Napi::Buffer<char> &buffer) {
-    if (_dbEnvPtr->IsStringValueMode())
-        return buffer.ToString();
-    return buffer;
+// Positions the cursor as mdbx_cursor_get without data, stepping over the record of the service dbi.
+int CppDbi::_cursorGet(MDBX_cursor *dbCur, MDBX_val *key, MDBX_cursor_op op) {
+    int rc = mdbx_cursor_get(dbCur, key, NULL, op);
+    if (rc == MDBX_SUCCESS && _isServiceKey(*key))
+        rc = mdbx_cursor_get(dbCur, key, NULL, (op == MDBX_LAST || op == MDBX_PREV) ? MDBX_PREV : MDBX_NEXT);
+    return rc;
+}
+
+// Page space reserved by putReserve may move on any write.
+void CppDbi::_beforeWrite() {
+    if (_reservedBuffers)
+        _reservedBuffers->DetachAll();
+}
+
+// Applying buffered writes is a write as well, even for read methods.
+void CppDbi::_flushWriteBuffer() {
+    if (_dbEnvPtr->HasBufferedWrites(_dbDbi))
+        _beforeWrite();
+    _dbEnvPtr->FlushWriteBuffer(_dbDbi);
+}
+
+Napi::Value CppDbi::_outKey(Napi::Env env, const MDBX_val &key) {
+    if (!_dbEnvPtr->IsStringKeyMode())
+        return Napi::Buffer<char>::Copy(env, (const char *) key.iov_base, key.iov_len);
+    if (_keyInternCache)
+        return _keyInternCache->Get(env, key);
+    return Napi::String::New(env, (const char *) key.iov_base, key.iov_len);
+}
+
+void CppDbi::_encodeValue(const Napi::Value &from, buffer_t &to) {
+    if (_parameters.valueMode == ValueMode::msgpack)
+        MsgpackEncode(from, to);
+    else
+        ExtractBuffer(from, to);
+}
+
+MDBX_val CppDbi::_inValue(const Napi::Value &from) {
+    _encodeValue(from, _valueBuffer);
+
+    if (_parameters.compression == Compression::none)
+        return CreateMdbxVal(_valueBuffer);
+    return CompressValue(_parameters.compression, _parameters.compressionThreshold, _valueBuffer, _compressedBuffer);
+}
+
+// Returns stored value with compression removed; decompressed data is placed into 'scratch'.
+MDBX_val CppDbi::_plainValue(const MDBX_val &value, buffer_t &scratch) {
+    if (_parameters.compression == Compression::none || !IsCompressedValue(value))
+        return value;
+
+    const size_t size = GetDecompressedSize(value);
+    scratch.resize(size);
+    DecompressValue(value, scratch.data(), size);
+    return CreateMdbxVal(scratch);
+}
+
+Napi::Value CppDbi::_outValue(Napi::Env env, const MDBX_val &value) {
+    MDBX_val plain = value;
+
+    if (_parameters.compression != Compression::none && IsCompressedValue(value)) {
+        const size_t size = GetDecompressedSize(value);
+        // Buffers are filled straight from the mapped page; other modes decode from the scratch buffer.
+        if (_parameters.valueMode == ValueMode::buffer) {
+            Napi::Buffer<char> result = Napi::Buffer<char>::New(env, size);
+            DecompressValue(value, result.Data(), size);
+            return result;
+        };
+        plain = _plainValue(value, _valueBuffer);
+    };
+
+    const char *data = (const char *) plain.iov_base;
+    switch (_parameters.valueMode) {
+        case ValueMode::string:
+            return Napi::String::New(env, data, plain.iov_len);
+        case ValueMode::msgpack:
+            return MsgpackDecode(env, data, plain.iov_len);
+        default:
+            return Napi::Buffer<char>::Copy(env, data, plain.iov_len);
+    };
 }
\ No newline at end of file
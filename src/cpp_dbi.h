@@ -3,6 +3,8 @@
 #include <napi.h>
 #include "mdbx.h"
 #include "db_env.h"
+#include "key_intern_cache.h"
+#include "reserved_buffers.h"
 #include "utils.h"
 
 class CppDbi : public Napi::ObjectWrap<CppDbi>
@@ -12,14 +14,29 @@ public:
 
     static Napi::Function GetClass(Napi::Env env);
 
-    void Init(const DbEnvPtr &dbEnvPtr, MDBX_dbi dbDbi, const std::string &name);
+    void Init(const DbEnvPtr &dbEnvPtr, const DbiInfo &dbiInfo, const std::string &name,
+        const KeyInternCachePtr &keyInternCache, const ReservedBuffersPtr &reservedBuffers);
+    MDBX_dbi GetDbi();
+    const DbiParameters & GetParameters();
 
     Napi::Value IsStale(const Napi::CallbackInfo& info);
+    Napi::Value InternStats(const Napi::CallbackInfo& info);
 
     Napi::Value Put(const Napi::CallbackInfo& info);
+    Napi::Value PutReserve(const Napi::CallbackInfo& info);
     Napi::Value Get(const Napi::CallbackInfo& info);
+    Napi::Value GetSlice(const Napi::CallbackInfo& info);
     Napi::Value Del(const Napi::CallbackInfo& info);
     Napi::Value Has(const Napi::CallbackInfo& info);
+    Napi::Value DelRange(const Napi::CallbackInfo& info);
+
+    Napi::Value Increment(const Napi::CallbackInfo& info);
+    Napi::Value PutIfAbsent(const Napi::CallbackInfo& info);
+    Napi::Value CompareAndSwap(const Napi::CallbackInfo& info);
+    Napi::Value Take(const Napi::CallbackInfo& info);
+
+    Napi::Value Sequence(const Napi::CallbackInfo& info);
+    Napi::Value PutAutoId(const Napi::CallbackInfo& info);
 
     Napi::Value FirstKey(const Napi::CallbackInfo& info);
     Napi::Value LastKey(const Napi::CallbackInfo& info);
@@ -29,12 +46,28 @@ public:
 
 private:
     void _check(Napi::Env &env);
-    Napi::Value _outKey(Napi::Buffer<char> &buffer);
-    Napi::Value _outValue(Napi::Buffer<char> &buffer);
+    void _beforeWrite();
+    void _flushWriteBuffer();
+    uint64_t _sequence(uint64_t increment);
+    bool _isWholeRange(MDBX_cursor *dbCur, const MDBX_val *gte, const MDBX_val *lt, uint64_t limit);
+    bool _isServiceKey(const MDBX_val &key);
+    int _cursorGet(MDBX_cursor *dbCur, MDBX_val *key, MDBX_cursor_op op);
+    Napi::Value _outKey(Napi::Env env, const MDBX_val &key);
+    MDBX_val _inValue(const Napi::Value &from);
+    void _encodeValue(const Napi::Value &from, buffer_t &to);
+    MDBX_val _plainValue(const MDBX_val &value, buffer_t &scratch);
+    Napi::Value _outValue(Napi::Env env, const MDBX_val &value);
 
     DbEnvPtr _dbEnvPtr;
     MDBX_dbi _dbDbi = 0;
+    DbiParameters _parameters;
+    MDBX_cmp_func *_keyCmp = NULL;
     std::string _name;
+    KeyInternCachePtr _keyInternCache;
+    ReservedBuffersPtr _reservedBuffers;
+    // Latency histograms of the dbi (NULL if latencies are not tracked).
+    DbiLatency *_latency = NULL;
     buffer_t _keyBuffer;
     buffer_t _valueBuffer;
+    buffer_t _compressedBuffer;
 };
@@ -1,15 +1,116 @@
 #include "cpp_mdbx.h"
 #include "cpp_dbi.h"
+#include "bulk_loader.h"
+#include "sync_worker.h"
+#include "compact_worker.h"
+#include "backup_worker.h"
+#include "analyzer.h"
+#include "open_worker.h"
 
 #include <algorithm>
 #include <iterator>
 #include <string>
 
-CppMdbx::CppMdbx(const Napi::CallbackInfo& info) : ObjectWrap(info) {
-    Napi::Env env = info.Env();
+static ValueMode ParseValueMode(Napi::Env env, const Napi::Value &value) {
+    std::string valueMode = value.ToString();
+    if (valueMode == "buffer")
+        return ValueMode::buffer;
+    if (valueMode == "string")
+        return ValueMode::string;
+    if (valueMode == "msgpack")
+        return ValueMode::msgpack;
+    throw Napi::Error::New(env, "Wrong valueMode; should be one of: 'string', 'buffer', 'msgpack'.");
+}
 
-    Napi::Object options = info[0].As<Napi::Object>();
+static Compression ParseCompression(Napi::Env env, const Napi::Value &value) {
+    if (value.IsUndefined() || value.IsNull())
+        return Compression::none;
+    std::string compression = value.ToString();
+    if (compression == "none")
+        return Compression::none;
+    if (compression == "lz4")
+        return Compression::lz4;
+    if (compression == "zstd")
+        throw Napi::Error::New(env, "zstd compression is not supported; use 'lz4'.");
+    throw Napi::Error::New(env, "Wrong compression; should be one of: 'none', 'lz4'.");
+}
+
+static KeyComparator ParseKeyComparator(Napi::Env env, const Napi::Value &value) {
+    if (value.IsUndefined() || value.IsNull())
+        return KeyComparator::none;
+    KeyComparator keyComparator;
+    if (FindKeyComparator(value.ToString(), keyComparator))
+        return keyComparator;
+    throw Napi::Error::New(env, "Wrong comparator; should be one of: 'default', 'lengthFirst', 'asciiCaseInsensitive'.");
+}
+
+static void ParseDbiParameters(Napi::Env env, const Napi::Object &options, DbiParameters &parameters) {
+    if (options.Has("valueMode"))
+        parameters.valueMode = ParseValueMode(env, options.Get("valueMode"));
+
+    if (options.Has("compression"))
+        parameters.compression = ParseCompression(env, options.Get("compression"));
+
+    if (options.Has("compressionThreshold")) {
+        const double threshold = options.Get("compressionThreshold").ToNumber();
+        if (!(threshold >= 0))
+            throw Napi::Error::New(env, "Wrong compressionThreshold; should be a non-negative number.");
+        parameters.compressionThreshold = (size_t) threshold;
+    };
+
+    if (options.Has("internKeys")) {
+        const double internKeys = options.Get("internKeys").ToNumber();
+        if (!(internKeys >= 0 && internKeys <= UINT32_MAX))
+            throw Napi::Error::New(env, "Wrong internKeys; should be a non-negative number.");
+        parameters.internKeys = (size_t) internKeys;
+    };
+
+    if (options.Has("reverseKey"))
+        parameters.reverseKey = options.Get("reverseKey").ToBoolean();
+
+    if (options.Has("comparator"))
+        parameters.keyComparator = ParseKeyComparator(env, options.Get("comparator"));
+
+    if (parameters.reverseKey && parameters.keyComparator != KeyComparator::none)
+        throw Napi::Error::New(env, "reverseKey and comparator options are mutually exclusive.");
+}
 
+static void ParseGeometrySize(Napi::Env env, const Napi::Object &options, const char *name, intptr_t &size) {
+    if (!options.Has(name))
+        return;
+    const double value = options.Get(name).ToNumber();
+    if (!(value >= 0 && value <= (double) INTPTR_MAX))
+        throw Napi::Error::New(env, std::string("Wrong ") + name + "; should be a non-negative number of bytes.");
+    size = (intptr_t) value;
+}
+
+static void ParseGeometry(Napi::Env env, const Napi::Object &options, DbGeometry &geometry) {
+    ParseGeometrySize(env, options, "sizeLower", geometry.sizeLower);
+    ParseGeometrySize(env, options, "sizeNow", geometry.sizeNow);
+    ParseGeometrySize(env, options, "sizeUpper", geometry.sizeUpper);
+    ParseGeometrySize(env, options, "growthStep", geometry.growthStep);
+    ParseGeometrySize(env, options, "shrinkThreshold", geometry.shrinkThreshold);
+}
+
+static MDBX_option_t ParseOptionName(Napi::Env env, const Napi::Value &value) {
+    MDBX_option_t option;
+    if (!DbEnv::FindOption(value.ToString(), option)) {
+        std::string names;
+        for (const auto &name : DbEnv::GetOptionNames())
+            names += (names.empty() ? "'" : ", '") + name + "'";
+        throw Napi::Error::New(env, "Wrong option name; should be one of: " + names + ".");
+    };
+    return option;
+}
+
+static uint64_t ParseOptionValue(Napi::Env env, MDBX_option_t option, const std::string &name, const Napi::Value &value) {
+    const double number = value.ToNumber();
+    if (!(number >= 0 && number < DbEnv::OptionFromMdbx(option, UINT64_MAX)))
+        throw Napi::Error::New(env, "Wrong " + name + "; should be a non-negative number.");
+    return DbEnv::OptionToMdbx(option, number);
+}
+
+static DbEnvParameters ParseDbEnvParameters(Napi::Env env, const Napi::Object &options) {
     if (!options.Get("path").IsString())
         throw Napi::Error::New(env, "DB path is not a string.");
     const std::string dbPath = options.Get("path").ToString();
@@ -17,6 +118,7 @@ CppMdbx::CppMdbx(const Napi::CallbackInfo& info) : ObjectWrap(info) {
         throw Napi::Error::New(env, "DB path is empty.");
     
     const bool readOnly = options.Get("readOnly").ToBoolean();
+    const bool writeMap = options.Get("writeMap").ToBoolean();
 
     intptr_t pageSize = -1;
     if (options.Has("pageSize"))
@@ -38,17 +140,9 @@ CppMdbx::CppMdbx(const Napi::CallbackInfo& info) : ObjectWrap(info) {
         };
     };
 
-    bool stringValueMode = false;
-    if (options.Has("valueMode")) {
-        std::string valueMode = options.Get("valueMode").ToString();
-        if (valueMode == "buffer") {
-            // nothing to do
-        } else if (valueMode == "string") {
-            stringValueMode = true;
-        } else {
-            throw Napi::Error::New(env, "Wrong valueMode; should be 'string' or 'buffer'.");
-        };
-    };
+    ValueMode valueMode = ValueMode::buffer;
+    if (options.Has("valueMode"))
+        valueMode = ParseValueMode(env, options.Get("valueMode"));
 
     SyncMode syncMode = SyncMode::durable;
     if (options.Has("syncMode")) {
@@ -66,17 +160,113 @@ CppMdbx::CppMdbx(const Napi::CallbackInfo& info) : ObjectWrap(info) {
         };
     };
 
-    const DbEnvParameters dbEnvParameters = {
+    Readahead readahead = Readahead::on;
+    if (options.Has("readahead")) {
+        const Napi::Value value = options.Get("readahead");
+        if (value.IsBoolean()) {
+            readahead = value.ToBoolean() ? Readahead::on : Readahead::off;
+        } else if (value.IsString() && value.ToString().Utf8Value() == "auto") {
+            readahead = Readahead::automatic;
+        } else {
+            throw Napi::Error::New(env, "Wrong readahead; should be true, false or 'auto'.");
+        };
+    };
+
+    unsigned syncInterval = 0;
+    if (options.Has("syncInterval")) {
+        const double value = options.Get("syncInterval").ToNumber();
+        if (!(value >= 0 && value <= UINT32_MAX))
+            throw Napi::Error::New(env, "Wrong syncInterval; should be a non-negative number of milliseconds.");
+        syncInterval = (unsigned) value;
+    };
+
+    unsigned latencySampling = 0;
+    if (options.Has("latencySampling")) {
+        Napi::Value value = options.Get("latencySampling");
+        const double rate = value.IsBoolean() ? (value.ToBoolean() ? 1 : 0) : value.ToNumber().DoubleValue();
+        if (!(rate >= 0 && rate <= UINT32_MAX))
+            throw Napi::Error::New(env, "Wrong latencySampling; should be a boolean or a non-negative number.");
+        latencySampling = (unsigned) rate;
+    };
+
+    DbGeometry geometry;
+    ParseGeometry(env, options, geometry);
+
+    std::vector<std::pair<MDBX_option_t, uint64_t>> envOptions;
+    for (const auto &name : DbEnv::GetOptionNames()) {
+        if (!options.Has(name))
+            continue;
+        MDBX_option_t option;
+        DbEnv::FindOption(name, option);
+        envOptions.emplace_back(option, ParseOptionValue(env, option, name, options.Get(name)));
+    };
+
+    std::vector<std::pair<std::string, DbiParameters>> dbis;
+    Napi::Value dbisValue = options.Get("dbis");
+    if (!dbisValue.IsUndefined() && !dbisValue.IsNull()) {
+        if (!dbisValue.IsArray())
+            throw Napi::Error::New(env, "Wrong dbis; should be an array.");
+        Napi::Array dbisArray = dbisValue.As<Napi::Array>();
+        for (uint32_t i = 0; i < dbisArray.Length(); i++) {
+            Napi::Value item = dbisArray.Get(i);
+            std::string name;
+            DbiParameters parameters;
+            parameters.valueMode = valueMode;
+            if (item.IsObject()) {
+                Napi::Object dbiOptions = item.As<Napi::Object>();
+                Napi::Value nameValue = dbiOptions.Get("name");
+                if (!nameValue.IsNull() && !nameValue.IsUndefined())
+                    name = nameValue.ToString();
+                ParseDbiParameters(env, dbiOptions, parameters);
+            } else if (item.IsString()) {
+                name = item.ToString();
+            } else {
+                throw Napi::Error::New(env, "Wrong dbis item; should be a name or an object with name and dbi options.");
+            };
+            dbis.emplace_back(name, parameters);
+        };
+    };
+
+    return DbEnvParameters {
         .dbPath = dbPath,
         .readOnly = readOnly,
         .pageSize = pageSize,
         .maxDbs = maxDbs,
         .stringKeyMode = stringKeyMode,
-        .stringValueMode = stringValueMode,
-        .syncMode = syncMode
+        .valueMode = valueMode,
+        .syncMode = syncMode,
+        .writeMap = writeMap,
+        .readahead = readahead,
+        .geometry = geometry,
+        .syncInterval = syncInterval,
+        .latencySampling = latencySampling,
+        .options = envOptions,
+        .dbis = dbis
+    };
+}
+
+CppMdbx::CppMdbx(const Napi::CallbackInfo& info) : ObjectWrap(info) {
+    Napi::Env env = info.Env();
+
+    Napi::Object options = info[0].As<Napi::Object>();
+    const DbEnvParameters dbEnvParameters = ParseDbEnvParameters(env, options);
+
+    // Environment could be opened beforehand (by OpenWorker).
+    if (info[1].IsExternal()) {
+        DbEnvPtr *opened = info[1].As<Napi::External<DbEnvPtr>>().Data();
+        _dbEnvPtr = std::move(*opened);
+    };
+    if (!_dbEnvPtr) {
+        _dbEnvPtr.reset(new DbEnv());
+        wrapException(env, [&]() {
+            _dbEnvPtr->Open(dbEnvParameters);
+        });
     };
-    _dbEnvPtr.reset(new DbEnv());
-    _dbEnvPtr->Open(dbEnvParameters);
+    _reservedBuffers.reset(new ReservedBuffers());
+
+    Napi::ArrayBuffer dbiGeneration = Napi::ArrayBuffer::New(env, sizeof(uint32_t));
+    _dbiGeneration = Napi::Persistent(dbiGeneration);
+    _dbEnvPtr->SetDbiGenerationStorage((uint32_t *) dbiGeneration.Data());
 
     _cppDbiConstructor = Napi::Persistent(CppDbi::GetClass(env));
 }
@@ -84,11 +274,43 @@ CppMdbx::CppMdbx(const Napi::CallbackInfo& info) : ObjectWrap(info) {
 Napi::Value CppMdbx::Close(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
 
+    if (_dbEnvPtr && _dbEnvPtr->IsBusy())
+        throw Napi::Error::New(env, "Database is busy with a background operation.");
+    if (_reservedBuffers)
+        _reservedBuffers->DetachAll();
     _dbClose();
 
     return env.Undefined();
 }
 
+// Shared counter, see DbEnv::GetDbiGeneration.
+Napi::Value CppMdbx::DbiGeneration(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+
+    _checkOpened(env);
+
+    return Napi::Uint32Array::New(env, 1, _dbiGeneration.Value(), 0);
+}
+
+// Lets cached dbis be reused when getDbi() is called with options.
+Napi::Value CppMdbx::IsDbiOpenedWith(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+
+    _checkOpened(env);
+
+    Napi::Value nameValue = info[0];
+    std::string name;
+    if (!nameValue.IsNull() && !nameValue.IsUndefined())
+        name = nameValue.ToString();
+
+    DbiParameters parameters;
+    parameters.valueMode = _dbEnvPtr->GetValueMode();
+    if (info[1].IsObject())
+        ParseDbiParameters(env, info[1].As<Napi::Object>(), parameters);
+
+    return Napi::Boolean::New(env, _dbEnvPtr->IsDbiOpenedWith(name, parameters));
+}
+
 void CppMdbx::_checkOpened(Napi::Env env) {
     if (!_dbEnvPtr || !_dbEnvPtr->IsOpened())
         throw Napi::Error::New(env, "Closed.");
@@ -102,19 +324,60 @@ Napi::Function CppMdbx::GetClass(Napi::Env env) {
     return DefineClass(env, "CppMdbx", {
         CppMdbx::InstanceMethod("close", &CppMdbx::Close),
         CppMdbx::InstanceMethod("getDbi", &CppMdbx::GetDbi),
+        CppMdbx::InstanceMethod("dbiGeneration", &CppMdbx::DbiGeneration),
+        CppMdbx::InstanceMethod("isDbiOpenedWith", &CppMdbx::IsDbiOpenedWith),
         CppMdbx::InstanceMethod("clearDbi", &CppMdbx::ClearDbi),
 
         CppMdbx::InstanceMethod("beginTransaction", &CppMdbx::BeginTransaction),
         CppMdbx::InstanceMethod("abortTransaction", &CppMdbx::AbortTransaction),
         CppMdbx::InstanceMethod("commitTransaction", &CppMdbx::CommitTransaction),
         CppMdbx::InstanceMethod("hasTransaction", &CppMdbx::HasTransaction),
+        CppMdbx::InstanceMethod("dirtyBytes", &CppMdbx::DirtyBytes),
+
+        CppMdbx::InstanceMethod("supportsNestedTransactions", &CppMdbx::SupportsNestedTransactions),
+        CppMdbx::InstanceMethod("beginNestedTransaction", &CppMdbx::BeginNestedTransaction),
+        CppMdbx::InstanceMethod("commitNestedTransaction", &CppMdbx::CommitNestedTransaction),
+        CppMdbx::InstanceMethod("abortNestedTransaction", &CppMdbx::AbortNestedTransaction),
+
+        CppMdbx::InstanceMethod("bulkLoadBatch", &CppMdbx::BulkLoadBatch),
+
+        CppMdbx::InstanceMethod("setGeometry", &CppMdbx::SetGeometry),
+        CppMdbx::InstanceMethod("setOption", &CppMdbx::SetOption),
+        CppMdbx::InstanceMethod("getOption", &CppMdbx::GetOption),
+        CppMdbx::InstanceMethod("stats", &CppMdbx::Stats),
+        CppMdbx::InstanceMethod("gcStats", &CppMdbx::GcStats),
+        CppMdbx::InstanceMethod("shrink", &CppMdbx::Shrink),
+        CppMdbx::InstanceMethod("isUsedByOtherProcesses", &CppMdbx::IsUsedByOtherProcesses),
+        CppMdbx::InstanceMethod("sync", &CppMdbx::Sync),
+        CppMdbx::InstanceMethod("compact", &CppMdbx::Compact),
+        CppMdbx::InstanceMethod("backup", &CppMdbx::Backup),
+        CppMdbx::InstanceMethod("analyze", &CppMdbx::AnalyzeOpened),
+
+        CppMdbx::StaticMethod("analyze", &CppMdbx::Analyze),
+        CppMdbx::StaticMethod("openAsync", &CppMdbx::OpenAsync),
     });
 }
 
 void CppMdbx::_dbClose() {
-    if (_dbEnvPtr)
+    // Environment in use is closed by the last background operation holding it.
+    if (_dbEnvPtr && !_dbEnvPtr->IsInUse())
         _dbEnvPtr->Close();
+    // Environment could outlive this object (held by a background operation).
+    if (_dbEnvPtr)
+        _dbEnvPtr->SetDbiGenerationStorage(NULL);
     _dbEnvPtr.reset();
+    _keyInternCaches.clear();
+    _reservedBuffers.reset();
+}
+
+KeyInternCachePtr CppMdbx::_getKeyInternCache(Napi::Env env, const std::string &name, const DbiParameters &parameters) {
+    if (parameters.internKeys == 0 || !_dbEnvPtr->IsStringKeyMode())
+        return KeyInternCachePtr();
+
+    KeyInternCachePtr &cache = _keyInternCaches[name];
+    if (!cache || cache->GetStats().capacity != parameters.internKeys)
+        cache.reset(new KeyInternCache(env, parameters.internKeys));
+    return cache;
 }
 
 Napi::Value CppMdbx::BeginTransaction(const Napi::CallbackInfo &info) {
@@ -122,8 +385,24 @@ Napi::Value CppMdbx::BeginTransaction(const Napi::CallbackInfo &info) {
 
     _checkOpened(env);
 
+    size_t autoSplitBytes = 0;
+    if (info[0].IsNumber()) {
+        const double value = info[0].ToNumber();
+        if (!(value >= 0))
+            throw Napi::Error::New(env, "Wrong autoSplitBytes; should be a non-negative number.");
+        autoSplitBytes = (size_t) value;
+    };
+
+    size_t writeBufferBytes = 0;
+    if (info[1].IsNumber()) {
+        const double value = info[1].ToNumber();
+        if (!(value >= 0))
+            throw Napi::Error::New(env, "Wrong writeBufferBytes; should be a non-negative number.");
+        writeBufferBytes = (size_t) value;
+    };
+
     wrapException(env, [&]() {
-        _dbEnvPtr->BeginTransaction();
+        _dbEnvPtr->BeginTransaction(autoSplitBytes, writeBufferBytes);
     });
 
     return env.Undefined();
@@ -139,6 +418,16 @@ Napi::Value CppMdbx::HasTransaction(const Napi::CallbackInfo &info) {
     return Napi::Value::From(env, hasTransaction);
 }
 
+Napi::Value CppMdbx::DirtyBytes(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+
+    _checkOpened(env);
+
+    return wrapException(env, [&]() {
+        return Napi::Value::From(env, (double) _dbEnvPtr->GetDirtyBytes());
+    });
+}
+
 Napi::Value CppMdbx::GetDbi(const Napi::CallbackInfo &info) {
     Napi::Env env = info.Env();
 
@@ -148,12 +437,20 @@ Napi::Value CppMdbx::GetDbi(const Napi::CallbackInfo &info) {
     std::string name;
     if (!nameValue.IsNull() && !nameValue.IsUndefined())
         name = nameValue.ToString();
+
+    bool hasParameters = false;
+    DbiParameters parameters;
+    parameters.valueMode = _dbEnvPtr->GetValueMode();
+    if (info[1].IsObject()) {
+        hasParameters = true;
+        ParseDbiParameters(env, info[1].As<Napi::Object>(), parameters);
+    };
     
     return wrapException(env, [&]() -> Napi::Value {
-        MDBX_dbi dbi = _dbEnvPtr->OpenDbi(name);
+        DbiInfo dbiInfo = _dbEnvPtr->OpenDbi(name, hasParameters ? &parameters : NULL);
         Napi::Value cppDbiValue = _cppDbiConstructor.New({});
         CppDbi *cppDbi = CppDbi::Unwrap(cppDbiValue.ToObject());
-        cppDbi->Init(_dbEnvPtr, dbi, name);
+        cppDbi->Init(_dbEnvPtr, dbiInfo, name, _getKeyInternCache(env, name, dbiInfo.parameters), _reservedBuffers);
         return cppDbiValue;
     });
 }
@@ -170,6 +467,8 @@ Napi::Value CppMdbx::ClearDbi(const Napi::CallbackInfo &info) {
 
     bool remove = info[1].ToBoolean();
 
+    _reservedBuffers->DetachAll();
+
     wrapException(env, [&]() {
         _dbEnvPtr->ClearDbi(name, remove);
     });
@@ -182,6 +481,8 @@ Napi::Value CppMdbx::CommitTransaction(const Napi::CallbackInfo &info) {
 
     _checkOpened(env);
 
+    _reservedBuffers->DetachAll();
+
     wrapException(env, [&]() {
         _dbEnvPtr->CommitTransaction();
     });
@@ -194,9 +495,398 @@ Napi::Value CppMdbx::AbortTransaction(const Napi::CallbackInfo &info) {
 
     _checkOpened(env);
 
+    _reservedBuffers->DetachAll();
+
     wrapException(env, [&]() {
         _dbEnvPtr->AbortTransaction();
     });
 
     return env.Undefined();
 }
+
+Napi::Value CppMdbx::SupportsNestedTransactions(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+
+    _checkOpened(env);
+
+    return Napi::Value::From(env, _dbEnvPtr->SupportsNestedTransactions());
+}
+
+Napi::Value CppMdbx::BeginNestedTransaction(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+
+    _checkOpened(env);
+
+    _reservedBuffers->DetachAll();
+
+    wrapException(env, [&]() {
+        _dbEnvPtr->BeginNestedTransaction();
+    });
+
+    return env.Undefined();
+}
+
+Napi::Value CppMdbx::CommitNestedTransaction(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+
+    _checkOpened(env);
+
+    _reservedBuffers->DetachAll();
+
+    wrapException(env, [&]() {
+        _dbEnvPtr->CommitNestedTransaction();
+    });
+
+    return env.Undefined();
+}
+
+Napi::Value CppMdbx::AbortNestedTransaction(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+
+    _checkOpened(env);
+
+    _reservedBuffers->DetachAll();
+
+    wrapException(env, [&]() {
+        _dbEnvPtr->AbortNestedTransaction();
+    });
+
+    return env.Undefined();
+}
+
+Napi::Value CppMdbx::SetGeometry(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+
+    _checkOpened(env);
+
+    // Omitted sizes remain unchanged.
+    DbGeometry geometry = { -1, -1, -1, -1, -1 };
+    if (info[0].IsObject())
+        ParseGeometry(env, info[0].As<Napi::Object>(), geometry);
+
+    wrapException(env, [&]() {
+        _dbEnvPtr->SetGeometry(geometry);
+    });
+
+    return env.Undefined();
+}
+
+Napi::Value CppMdbx::SetOption(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+
+    _checkOpened(env);
+
+    const MDBX_option_t option = ParseOptionName(env, info[0]);
+    const uint64_t value = ParseOptionValue(env, option, info[0].ToString(), info[1]);
+
+    wrapException(env, [&]() {
+        _dbEnvPtr->SetOption(option, value);
+    });
+
+    return env.Undefined();
+}
+
+Napi::Value CppMdbx::GetOption(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+
+    _checkOpened(env);
+
+    const MDBX_option_t option = ParseOptionName(env, info[0]);
+
+    return wrapException(env, [&]() {
+        return Napi::Value::From(env, DbEnv::OptionFromMdbx(option, _dbEnvPtr->GetOption(option)));
+    });
+}
+
+// Durations are converted from nanoseconds to microseconds.
+static Napi::Object LatencyHistogramToObject(Napi::Env env, const LatencyHistogram &histogram) {
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("count", (double) histogram.GetCount());
+    result.Set("min", histogram.GetMin() / 1000.0);
+    result.Set("mean", histogram.GetMean() / 1000.0);
+    result.Set("p50", histogram.GetPercentile(50) / 1000.0);
+    result.Set("p90", histogram.GetPercentile(90) / 1000.0);
+    result.Set("p99", histogram.GetPercentile(99) / 1000.0);
+    result.Set("p999", histogram.GetPercentile(99.9) / 1000.0);
+    result.Set("max", histogram.GetMax() / 1000.0);
+    return result;
+}
+
+static Napi::Object LatencyStatsToObject(Napi::Env env, const LatencyStats &latencyStats) {
+    static const char *const OPERATIONS[] = { "get", "has", "put", "del", "delRange", "update", "cursor" };
+
+    Napi::Object dbis = Napi::Object::New(env);
+    for (const auto &dbi : latencyStats.GetDbis()) {
+        Napi::Object operations = Napi::Object::New(env);
+        for (size_t op = 0; op < dbi.second.size(); op++) {
+            if (dbi.second[op].GetCount() > 0)
+                operations.Set(OPERATIONS[op], LatencyHistogramToObject(env, dbi.second[op]));
+        };
+        dbis.Set(dbi.first, operations);
+    };
+
+    const CommitLatency &commitLatency = latencyStats.GetCommit();
+    Napi::Object commit = Napi::Object::New(env);
+    commit.Set("preparation", LatencyHistogramToObject(env, commitLatency.preparation));
+    commit.Set("gc", LatencyHistogramToObject(env, commitLatency.gc));
+    commit.Set("write", LatencyHistogramToObject(env, commitLatency.write));
+    commit.Set("sync", LatencyHistogramToObject(env, commitLatency.sync));
+    commit.Set("ending", LatencyHistogramToObject(env, commitLatency.ending));
+    commit.Set("whole", LatencyHistogramToObject(env, commitLatency.whole));
+
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("sampling", (double) latencyStats.GetSampleRate());
+    result.Set("begin", LatencyHistogramToObject(env, latencyStats.GetBegin()));
+    result.Set("abort", LatencyHistogramToObject(env, latencyStats.GetAbort()));
+    result.Set("commit", commit);
+    result.Set("dbis", dbis);
+    return result;
+}
+
+Napi::Value CppMdbx::Stats(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+
+    _checkOpened(env);
+
+    return wrapException(env, [&]() {
+        const MDBX_envinfo envInfo = _dbEnvPtr->GetInfo();
+        const GeometryChanges &changes = _dbEnvPtr->GetGeometryChanges();
+
+        Napi::Object geometry = Napi::Object::New(env);
+        geometry.Set("sizeLower", (double) envInfo.mi_geo.lower);
+        geometry.Set("sizeNow", (double) envInfo.mi_geo.current);
+        geometry.Set("sizeUpper", (double) envInfo.mi_geo.upper);
+        geometry.Set("growthStep", (double) envInfo.mi_geo.grow);
+        geometry.Set("shrinkThreshold", (double) envInfo.mi_geo.shrink);
+        geometry.Set("mapSize", (double) envInfo.mi_mapsize);
+        geometry.Set("grows", (double) changes.grows);
+        geometry.Set("shrinks", (double) changes.shrinks);
+        geometry.Set("remaps", (double) changes.remaps);
+
+        const ReadaheadInfo &readaheadInfo = _dbEnvPtr->GetReadaheadInfo();
+        static const char *const READAHEAD_MODES[] = { "on", "off", "auto" };
+        Napi::Object readahead = Napi::Object::New(env);
+        readahead.Set("mode", READAHEAD_MODES[(int) readaheadInfo.mode]);
+        readahead.Set("enabled", readaheadInfo.enabled);
+        readahead.Set("reasonable", readaheadInfo.reasonable);
+        readahead.Set("checkedSize", (double) readaheadInfo.checkedSize);
+        readahead.Set("reason", readaheadInfo.reason);
+
+        const PeriodicSyncStats syncStats = _dbEnvPtr->GetPeriodicSyncStats();
+        Napi::Object sync = Napi::Object::New(env);
+        sync.Set("unsyncedBytes", (double) envInfo.mi_unsync_volume);
+        sync.Set("sinceSync", envInfo.mi_since_sync_seconds16dot16 / 65536.0);
+        sync.Set("interval", (double) syncStats.interval);
+        sync.Set("synced", (double) syncStats.synced);
+        sync.Set("clean", (double) syncStats.clean);
+        sync.Set("busy", (double) syncStats.busy);
+        sync.Set("errors", (double) syncStats.errors);
+        if (syncStats.lastError != MDBX_SUCCESS)
+            sync.Set("lastError", mdbx_strerror(syncStats.lastError));
+
+        Napi::Object result = Napi::Object::New(env);
+        result.Set("pageSize", (double) envInfo.mi_dxb_pagesize);
+        result.Set("lastPage", (double) envInfo.mi_last_pgno);
+        result.Set("recentTxnId", (double) envInfo.mi_recent_txnid);
+        result.Set("readers", (double) envInfo.mi_numreaders);
+        result.Set("geometry", geometry);
+        result.Set("readahead", readahead);
+        result.Set("sync", sync);
+
+        LatencyStats &latencyStats = _dbEnvPtr->GetLatencyStats();
+        if (latencyStats.IsEnabled()) {
+            result.Set("latency", LatencyStatsToObject(env, latencyStats));
+            if (info[0].ToBoolean())
+                latencyStats.Reset();
+        };
+        return result;
+    });
+}
+
+Napi::Value CppMdbx::GcStats(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+
+    _checkOpened(env);
+
+    return wrapException(env, [&]() {
+        const GcInfo gcInfo = _dbEnvPtr->GetGcInfo();
+
+        Napi::Object result = Napi::Object::New(env);
+        result.Set("pageSize", (double) gcInfo.pageSize);
+        result.Set("totalPages", (double) gcInfo.totalPages);
+        result.Set("usedPages", (double) gcInfo.usedPages);
+        result.Set("unallocatedPages", (double) (gcInfo.totalPages - gcInfo.usedPages));
+        result.Set("gcEntries", (double) gcInfo.gcEntries);
+        result.Set("gcTreePages", (double) gcInfo.gcTreePages);
+        if (gcInfo.walked) {
+            result.Set("freePages", (double) gcInfo.freePages);
+            result.Set("reclaimablePages", (double) gcInfo.reclaimablePages);
+            result.Set("pinnedPages", (double) gcInfo.pinnedPages);
+            result.Set("livePages", (double) (gcInfo.usedPages - std::min(gcInfo.freePages, gcInfo.usedPages)));
+            result.Set("lastTxnWithFreePages", (double) gcInfo.lastTxnWithFreePages);
+        };
+        result.Set("oldestReaderTxnId", (double) gcInfo.oldestReaderTxnId);
+        result.Set("recentTxnId", (double) gcInfo.recentTxnId);
+        return result;
+    });
+}
+
+Napi::Value CppMdbx::Shrink(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+
+    _checkOpened(env);
+
+    return wrapException(env, [&]() {
+        const uint64_t before = _dbEnvPtr->GetInfo().mi_geo.current;
+        _dbEnvPtr->Shrink();
+        const uint64_t after = _dbEnvPtr->GetInfo().mi_geo.current;
+        return Napi::Number::New(env, (double) (before > after ? before - after : 0));
+    });
+}
+
+Napi::Value CppMdbx::IsUsedByOtherProcesses(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+
+    _checkOpened(env);
+
+    return wrapException(env, [&]() {
+        return Napi::Value::From(env, _dbEnvPtr->IsUsedByOtherProcesses());
+    });
+}
+
+Napi::Value CppMdbx::Sync(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+
+    _checkOpened(env);
+
+    SyncWorker *worker = new SyncWorker(env, _dbEnvPtr);
+    worker->Queue();
+    return worker->GetPromise();
+}
+
+Napi::Value CppMdbx::Compact(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+
+    _checkOpened(env);
+
+    if (!info[0].IsString())
+        throw Napi::Error::New(env, "Target path is not a string.");
+    const std::string target = info[0].ToString();
+
+    CompactWorker *worker = new CompactWorker(env, _dbEnvPtr, target);
+    worker->Queue();
+    return worker->GetPromise();
+}
+
+Napi::Value CppMdbx::Backup(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+
+    _checkOpened(env);
+
+    const bool compact = info[0].ToBoolean();
+
+    BackupWorker *worker = new BackupWorker(env, _dbEnvPtr, compact);
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("fd", worker->GetReadFd());
+    result.Set("promise", worker->GetPromise());
+    worker->Queue();
+    return result;
+}
+
+static void ParseAnalyzeOptions(Napi::Env env, const Napi::Value &value, AnalyzeParameters &parameters) {
+    if (!value.IsObject())
+        return;
+    Napi::Object options = value.As<Napi::Object>();
+    if (options.Has("maxDbs"))
+        parameters.maxDbs = (unsigned) options.Get("maxDbs").ToNumber();
+    if (options.Has("sampleLimit")) {
+        const double sampleLimit = options.Get("sampleLimit").ToNumber();
+        if (!(sampleLimit > 0))
+            throw Napi::Error::New(env, "Wrong sampleLimit; should be a positive number.");
+        parameters.sampleLimit = (uint64_t) sampleLimit;
+    };
+}
+
+Napi::Value CppMdbx::Analyze(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+
+    AnalyzeParameters parameters;
+    if (!info[0].IsString())
+        throw Napi::Error::New(env, "DB path is not a string.");
+    parameters.dbPath = info[0].ToString();
+    ParseAnalyzeOptions(env, info[1], parameters);
+
+    AnalyzeWorker *worker = new AnalyzeWorker(env, std::move(parameters));
+    worker->Queue();
+    return worker->GetPromise();
+}
+
+Napi::Value CppMdbx::AnalyzeOpened(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+
+    _checkOpened(env);
+
+    AnalyzeParameters parameters;
+    ParseAnalyzeOptions(env, info[0], parameters);
+
+    AnalyzeWorker *worker = new AnalyzeWorker(env, _dbEnvPtr, std::move(parameters));
+    worker->Queue();
+    return worker->GetPromise();
+}
+
+Napi::Value CppMdbx::OpenAsync(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+
+    Napi::Object options = info[0].As<Napi::Object>();
+    OpenWorker *worker = new OpenWorker(env, ParseDbEnvParameters(env, options));
+    worker->Queue();
+    return worker->GetPromise();
+}
+
+Napi::Value CppMdbx::BulkLoadBatch(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+
+    _checkOpened(env);
+
+    CppDbi *cppDbi = CppDbi::Unwrap(info[0].ToObject());
+    Napi::Object options = info[1].As<Napi::Object>();
+
+    BulkLoadParameters parameters;
+    parameters.dbi = cppDbi->GetDbi();
+    parameters.dbiParameters = cppDbi->GetParameters();
+    // Records are stored as is: that's the form of 'buffer' and 'string' values, but not of msgpack ones.
+    if (parameters.dbiParameters.valueMode == ValueMode::msgpack)
+        throw Napi::Error::New(env, "Bulk load is not supported for dbis with msgpack valueMode.");
+    parameters.sorted = options.Get("sorted").ToBoolean();
+    parameters.resume = options.Get("resume").ToBoolean();
+    parameters.last = options.Get("last").ToBoolean();
+
+    if (options.Has("format")) {
+        std::string format = options.Get("format").ToString();
+        if (format == "lengthPrefixed") {
+            // nothing to do
+        } else if (format == "lines") {
+            parameters.format = BulkRecordFormat::lines;
+        } else {
+            throw Napi::Error::New(env, "Wrong format; should be 'lengthPrefixed' or 'lines'.");
+        };
+    };
+
+    if (options.Has("txnBytes")) {
+        const double txnBytes = options.Get("txnBytes").ToNumber();
+        if (!(txnBytes > 0))
+            throw Napi::Error::New(env, "Wrong txnBytes; should be a positive number.");
+        parameters.txnBytes = (size_t) txnBytes;
+    };
+
+    if (options.Get("fd").IsNumber())
+        parameters.fd = options.Get("fd").ToNumber();
+
+    Napi::Value data = options.Get("data");
+    if (!data.IsUndefined() && !data.IsNull())
+        ExtractBuffer(data, parameters.data);
+
+    BulkLoadWorker *worker = new BulkLoadWorker(env, _dbEnvPtr, std::move(parameters));
+    worker->Queue();
+    return worker->GetPromise();
+}
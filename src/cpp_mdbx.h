@@ -4,6 +4,8 @@
 #include "mdbx.h"
 
 #include "db_env.h"
+#include "key_intern_cache.h"
+#include "reserved_buffers.h"
 
 class CppMdbx : public Napi::ObjectWrap<CppMdbx>
 {
@@ -12,12 +14,33 @@ public:
 
     Napi::Value Close(const Napi::CallbackInfo&);
     Napi::Value GetDbi(const Napi::CallbackInfo&);
+    Napi::Value DbiGeneration(const Napi::CallbackInfo&);
+    Napi::Value IsDbiOpenedWith(const Napi::CallbackInfo&);
     Napi::Value ClearDbi(const Napi::CallbackInfo&);
     Napi::Value BeginTransaction(const Napi::CallbackInfo&);
     Napi::Value HasTransaction(const Napi::CallbackInfo&);
+    Napi::Value DirtyBytes(const Napi::CallbackInfo&);
     Napi::Value CommitTransaction(const Napi::CallbackInfo&);
     Napi::Value AbortTransaction(const Napi::CallbackInfo&);
+    Napi::Value SupportsNestedTransactions(const Napi::CallbackInfo&);
+    Napi::Value BeginNestedTransaction(const Napi::CallbackInfo&);
+    Napi::Value CommitNestedTransaction(const Napi::CallbackInfo&);
+    Napi::Value AbortNestedTransaction(const Napi::CallbackInfo&);
+    Napi::Value BulkLoadBatch(const Napi::CallbackInfo&);
+    Napi::Value SetGeometry(const Napi::CallbackInfo&);
+    Napi::Value SetOption(const Napi::CallbackInfo&);
+    Napi::Value GetOption(const Napi::CallbackInfo&);
+    Napi::Value Stats(const Napi::CallbackInfo&);
+    Napi::Value GcStats(const Napi::CallbackInfo&);
+    Napi::Value Shrink(const Napi::CallbackInfo&);
+    Napi::Value IsUsedByOtherProcesses(const Napi::CallbackInfo&);
+    Napi::Value Sync(const Napi::CallbackInfo&);
+    Napi::Value Compact(const Napi::CallbackInfo&);
+    Napi::Value Backup(const Napi::CallbackInfo&);
+    Napi::Value AnalyzeOpened(const Napi::CallbackInfo&);
     
+    static Napi::Value Analyze(const Napi::CallbackInfo&);
+    static Napi::Value OpenAsync(const Napi::CallbackInfo&);
     static Napi::Function GetClass(Napi::Env);
 
     ~CppMdbx();
@@ -25,7 +48,11 @@ public:
 private:
     void _dbClose();
     void _checkOpened(Napi::Env);
+    KeyInternCachePtr _getKeyInternCache(Napi::Env, const std::string &name, const DbiParameters &parameters);
     
     DbEnvPtr _dbEnvPtr;
     Napi::FunctionReference _cppDbiConstructor;
+    std::map<std::string, KeyInternCachePtr> _keyInternCaches;
+    ReservedBuffersPtr _reservedBuffers;
+    Napi::Reference<Napi::ArrayBuffer> _dbiGeneration;
 };
@@ -1,5 +1,59 @@
 #include "db_env.h"
 
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <string>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+static const struct {
+    const char *name;
+    MDBX_option_t option;
+    // Option can only be set for the opened environment.
+    bool afterOpen;
+    // MDBX units per unit of the option, e.g. 1/65536 of second per millisecond.
+    double scale;
+} ENV_OPTIONS[] = {
+    { "txnDpLimit", MDBX_opt_txn_dp_limit, false, 1 },
+    { "txnDpInitial", MDBX_opt_txn_dp_initial, false, 1 },
+    { "dpReserveLimit", MDBX_opt_dp_reserve_limit, false, 1 },
+    { "looseLimit", MDBX_opt_loose_limit, false, 1 },
+    { "rpAugmentLimit", MDBX_opt_rp_augment_limit, false, 1 },
+    { "spillMaxDenominator", MDBX_opt_spill_max_denominator, false, 1 },
+    { "spillMinDenominator", MDBX_opt_spill_min_denominator, false, 1 },
+    { "spillParent4ChildDenominator", MDBX_opt_spill_parent4child_denominator, false, 1 },
+    { "mergeThresholdPercent", MDBX_opt_merge_threshold_16dot16_percent, false, 65536 / 100.0 },
+    { "syncBytes", MDBX_opt_sync_bytes, true, 1 },
+    { "syncPeriodMs", MDBX_opt_sync_period, true, 65536 / 1000.0 },
+};
+
+// Sync options poll the sync on change and pass its MDBX_RESULT_TRUE (nothing to sync) through.
+static void CheckOptionResult(int rc) {
+    if (rc != MDBX_RESULT_TRUE)
+        CheckMdbxResult(rc);
+}
+
+static double GetOptionScale(MDBX_option_t option) {
+    for (const auto &envOption : ENV_OPTIONS) {
+        if (envOption.option == option)
+            return envOption.scale;
+    };
+    return 1;
+}
+
+static bool IsAfterOpenOption(MDBX_option_t option) {
+    for (const auto &envOption : ENV_OPTIONS) {
+        if (envOption.option == option)
+            return envOption.afterOpen;
+    };
+    return false;
+}
+
 void DbEnv::Open(const DbEnvParameters &parameters) {
     if (_env)
         throw DbException("Already opened.");
@@ -11,47 +65,106 @@ void DbEnv::Open(const DbEnvParameters &parameters) {
         rc = mdbx_env_create(&env);
         CheckMdbxResult(rc);
 
-        if (parameters.maxDbs > 0) {
-            rc = mdbx_env_set_maxdbs(env, (MDBX_dbi) parameters.maxDbs);
+        // One more slot is reserved for the service dbi, unless named dbis are not used at all.
+        rc = mdbx_env_set_maxdbs(env, parameters.maxDbs > 0 ? (MDBX_dbi) parameters.maxDbs + 1 : 0);
+        CheckMdbxResult(rc);
+
+        for (const auto &option : parameters.options) {
+            if (IsAfterOpenOption(option.first))
+                continue;
+            rc = mdbx_env_set_option(env, option.first, option.second);
             CheckMdbxResult(rc);
         };
 
+        const DbGeometry &geometry = parameters.geometry;
         rc = mdbx_env_set_geometry(
             env,
-            -1, // size_lower
-            -1, // size_now
-            256 * 1024 * MB, // size_upper
-            4 * MB, // growth_step
-            16 * MB, // shrink_threshold
+            geometry.sizeLower,
+            geometry.sizeNow,
+            geometry.sizeUpper,
+            geometry.growthStep,
+            geometry.shrinkThreshold,
             parameters.pageSize
         );
         CheckMdbxResult(rc);
 
+        _readahead = ReadaheadInfo();
+        _readahead.mode = parameters.readahead;
+        if (parameters.readahead == Readahead::automatic) {
+            uint64_t size = GetFileSize(parameters.dbPath + "/mdbx.dat");
+            size = std::max<uint64_t>(size, (uint64_t) std::max<intptr_t>(geometry.sizeNow, geometry.sizeLower));
+            _checkReadahead(size);
+            _readahead.enabled = _readahead.reasonable;
+        } else {
+            _readahead.enabled = parameters.readahead == Readahead::on;
+            _readahead.reason = _readahead.enabled ? "enabled by option" : "disabled by option";
+        };
+
         MDBX_env_flags_t envFlags = MDBX_ACCEDE | MDBX_LIFORECLAIM | (MDBX_env_flags_t) parameters.syncMode;
+        if (!_readahead.enabled)
+            envFlags |= MDBX_NORDAHEAD;
         if (parameters.readOnly)
             envFlags |= MDBX_RDONLY;
+        else if (parameters.writeMap)
+            envFlags |= MDBX_WRITEMAP;
         rc = mdbx_env_open(env, parameters.dbPath.c_str(), envFlags, 0666);
         CheckMdbxResult(rc);
 
+        for (const auto &option : parameters.options) {
+            if (!IsAfterOpenOption(option.first))
+                continue;
+            rc = mdbx_env_set_option(env, option.first, option.second);
+            CheckOptionResult(rc);
+        };
+
         _env = env;
         _readOnly = parameters.readOnly;
+        _maxDbs = parameters.maxDbs;
+        _writeMap = !parameters.readOnly && parameters.writeMap;
         _stringKeyMode = parameters.stringKeyMode;
-        _stringValueMode = parameters.stringValueMode;
+        _valueMode = parameters.valueMode;
+        _geometryChanges = GeometryChanges();
+        _datafileSize = 0;
+        _mapSize = 0;
+        _trackGeometry();
+        _latencyStats.SetSampleRate(parameters.latencySampling);
+
+        if (!parameters.readOnly && parameters.syncInterval > 0)
+            _periodicSync.Start(_env, parameters.syncInterval);
     } catch(...) {
+        _periodicSync.Stop();
+        _env = NULL;
         if (env)
             mdbx_env_close(env);
         throw;
     };
+
+    try {
+        OpenDbis(parameters.dbis);
+    } catch(...) {
+        Close();
+        throw;
+    };
 }
 
 void DbEnv::Close() {
+    _checkNotBusy();
+    if (_backgroundReaders > 0)
+        throw DbException("Database is used by a background operation.");
+
     if (_env) {
+        _periodicSync.Stop();
         mdbx_env_close(_env);
         _env = NULL;
         _readOnly = false;
+        _writeMap = false;
         _txn = NULL;
+        _writeBuffer.Reset(0);
         _pendingTransactionDbis.clear();
+        _parentTxns.clear();
+        _parentPendingDbis.clear();
         _openedDbis.clear();
+        ++*_dbiGeneration;
     };
 }
 
@@ -63,12 +176,362 @@ bool DbEnv::IsReadOnly() {
     return _readOnly;
 }
 
-MDBX_dbi DbEnv::OpenDbi(const std::string &name) {
+bool DbEnv::FindOption(const std::string &name, MDBX_option_t &option) {
+    for (const auto &envOption : ENV_OPTIONS) {
+        if (name == envOption.name) {
+            option = envOption.option;
+            return true;
+        };
+    };
+    return false;
+}
+
+uint64_t DbEnv::OptionToMdbx(MDBX_option_t option, double value) {
+    return (uint64_t) std::round(value * GetOptionScale(option));
+}
+
+double DbEnv::OptionFromMdbx(MDBX_option_t option, uint64_t value) {
+    return value / GetOptionScale(option);
+}
+
+std::vector<std::string> DbEnv::GetOptionNames() {
+    std::vector<std::string> result;
+    for (const auto &envOption : ENV_OPTIONS)
+        result.push_back(envOption.name);
+    return result;
+}
+
+void DbEnv::SetOption(MDBX_option_t option, uint64_t value) {
+    _checkOpened();
+    // Background write transaction would block the call.
+    _checkNotBusy();
+
+    const int rc = mdbx_env_set_option(_env, option, value);
+    CheckOptionResult(rc);
+}
+
+uint64_t DbEnv::GetOption(MDBX_option_t option) {
+    _checkOpened();
+
+    uint64_t value = 0;
+    const int rc = mdbx_env_get_option(_env, option, &value);
+    CheckMdbxResult(rc);
+    return value;
+}
+
+// Changing geometry of the opened environment starts its own write transaction.
+void DbEnv::SetGeometry(const DbGeometry &geometry) {
+    _checkOpened();
+    _checkNotTransaction();
+    _checkNotBusy();
+
+    const int rc = mdbx_env_set_geometry(
+        _env,
+        geometry.sizeLower,
+        geometry.sizeNow,
+        geometry.sizeUpper,
+        geometry.growthStep,
+        geometry.shrinkThreshold,
+        -1
+    );
+    CheckMdbxResult(rc);
+    _trackGeometry();
+}
+
+MDBX_envinfo DbEnv::GetInfo() {
+    _checkOpened();
+
+    MDBX_envinfo info;
+    const int rc = mdbx_env_info_ex(_env, NULL, &info, sizeof(info));
+    CheckMdbxResult(rc);
+    return info;
+}
+
+// Handle of GC table (FREE_DBI) is fixed, though not exported by mdbx.h.
+static const MDBX_dbi GC_DBI = 0;
+
+static void StatGc(MDBX_txn *txn, GcInfo &gcInfo) {
+    MDBX_stat stat;
+    const int rc = mdbx_dbi_stat(txn, GC_DBI, &stat, sizeof(stat));
+    CheckMdbxResult(rc);
+    gcInfo.gcEntries = stat.ms_entries;
+    gcInfo.gcTreePages = stat.ms_branch_pages + stat.ms_leaf_pages + stat.ms_overflow_pages;
+}
+
+// Cursors of GC table can be opened in read-only transactions only.
+static void WalkGc(MDBX_txn *txn, GcInfo &gcInfo) {
+    StatGc(txn, gcInfo);
+
+    MDBX_cursor *dbCur = NULL;
+    int rc = mdbx_cursor_open(txn, GC_DBI, &dbCur);
+    CheckMdbxResult(rc);
+
+    try {
+        MDBX_val key, value;
+        // Key is id of the transaction, value is the list of retired page numbers prefixed by its length.
+        rc = mdbx_cursor_get(dbCur, &key, &value, MDBX_FIRST);
+        while (rc == MDBX_SUCCESS) {
+            if (key.iov_len != sizeof(uint64_t) || value.iov_len < sizeof(uint32_t))
+                throw DbException("Unexpected GC record.");
+            uint64_t txnId;
+            memcpy(&txnId, key.iov_base, sizeof(txnId));
+            uint32_t count;
+            memcpy(&count, value.iov_base, sizeof(count));
+
+            gcInfo.freePages += count;
+            if (txnId < gcInfo.oldestReaderTxnId)
+                gcInfo.reclaimablePages += count;
+            else
+                gcInfo.pinnedPages += count;
+            gcInfo.lastTxnWithFreePages = std::max(gcInfo.lastTxnWithFreePages, txnId);
+
+            rc = mdbx_cursor_get(dbCur, &key, &value, MDBX_NEXT);
+        };
+        if (rc != MDBX_NOTFOUND)
+            CheckMdbxResult(rc);
+    } catch(...) {
+        mdbx_cursor_close(dbCur);
+        throw;
+    };
+    mdbx_cursor_close(dbCur);
+}
+
+GcInfo DbEnv::GetGcInfo() {
+    _checkOpened();
+
+    // Taken before the own read transaction is started, which would be the oldest one otherwise.
+    MDBX_envinfo info;
+    int rc = mdbx_env_info_ex(_env, _txn, &info, sizeof(info));
+    CheckMdbxResult(rc);
+
+    GcInfo gcInfo;
+    gcInfo.pageSize = info.mi_dxb_pagesize;
+    gcInfo.totalPages = info.mi_geo.current / info.mi_dxb_pagesize;
+    gcInfo.usedPages = info.mi_last_pgno + 1;
+    gcInfo.oldestReaderTxnId = info.mi_latter_reader_txnid;
+    gcInfo.recentTxnId = info.mi_recent_txnid;
+
+    if (_txn != NULL) {
+        // Read transaction can't be started by the thread of a write one, so GC table is not walked then.
+        if (_readOnly) {
+            WalkGc(_txn, gcInfo);
+        } else {
+            StatGc(_txn, gcInfo);
+            gcInfo.walked = false;
+        };
+        return gcInfo;
+    };
+
+    MDBX_txn *txn = NULL;
+    rc = mdbx_txn_begin(_env, NULL, MDBX_TXN_RDONLY, &txn);
+    CheckMdbxResult(rc);
+    try {
+        WalkGc(txn, gcInfo);
+    } catch(...) {
+        mdbx_txn_abort(txn);
+        throw;
+    };
+    mdbx_txn_abort(txn);
+    return gcInfo;
+}
+
+static int FindLargestSnapshot(void *ctx, int, int, mdbx_pid_t, mdbx_tid_t, uint64_t, uint64_t, size_t bytesUsed, size_t) MDBX_CXX17_NOEXCEPT {
+    size_t &largest = *(size_t *) ctx;
+    largest = std::max(largest, bytesUsed);
+    return MDBX_RESULT_FALSE;
+}
+
+#ifndef _WIN32
+// Tests whether a byte range of the file is locked by somebody else. OFD locks are owned by the open file
+// description, so locks taken through the same descriptor don't conflict with the test.
+static bool IsRangeLocked(int fd, off_t start, off_t length) {
+    struct flock lock;
+    std::memset(&lock, 0, sizeof(lock));
+    lock.l_type = F_WRLCK;
+    lock.l_whence = SEEK_SET;
+    lock.l_start = start;
+    lock.l_len = length;
+#ifdef F_OFD_GETLK
+    int rc = fcntl(fd, F_OFD_GETLK, &lock);
+    if (rc != 0 && errno == EINVAL)
+        rc = fcntl(fd, F_GETLK, &lock);
+#else
+    const int rc = fcntl(fd, F_GETLK, &lock);
+#endif
+    if (rc != 0)
+        throw DbException(std::string("Can't test datafile locks: ") + std::strerror(errno));
+    return lock.l_type != F_UNLCK;
+}
+#endif
+
+bool DbEnv::IsUsedByOtherProcesses() {
+    _checkOpened();
+
+#ifdef _WIN32
+    // Files opened by other processes can't be replaced on Windows anyway.
+    return false;
+#else
+    // Each process keeps the datafile byte at the offset of its pid locked while the environment is opened.
+    mdbx_filehandle_t fd;
+    const int rc = mdbx_env_get_fd(_env, &fd);
+    CheckMdbxResult(rc);
+    const off_t pid = (off_t) getpid();
+    return IsRangeLocked(fd, 0, pid) || IsRangeLocked(fd, pid + 1, 0);
+#endif
+}
+
+void DbEnv::Shrink() {
+    _checkOpened();
+    _checkNotTransaction();
+    _checkNotBusy();
+    if (_readOnly)
+        throw DbException("Database is opened in read-only mode.");
+
+    MDBX_txn *txn = NULL;
+    int rc = mdbx_txn_begin(_env, NULL, MDBX_TXN_READWRITE, &txn);
+    CheckMdbxResult(rc);
+
+    try {
+        MDBX_envinfo info;
+        rc = mdbx_env_info_ex(_env, txn, &info, sizeof(info));
+        CheckMdbxResult(rc);
+
+        // New size should cover the pages used by snapshots of readers as well.
+        size_t usedBytes = (info.mi_last_pgno + 1) * (size_t) info.mi_dxb_pagesize;
+        rc = mdbx_reader_list(_env, FindLargestSnapshot, &usedBytes);
+        if (rc != MDBX_RESULT_TRUE)
+            CheckMdbxResult(rc);
+
+        if (usedBytes < info.mi_geo.current) {
+            rc = mdbx_env_set_geometry(_env, -1, (intptr_t) usedBytes, -1, -1, -1, -1);
+            CheckMdbxResult(rc);
+        };
+
+        rc = mdbx_txn_commit(txn);
+        txn = NULL;
+        CheckMdbxResult(rc);
+    } catch(...) {
+        if (txn)
+            mdbx_txn_abort(txn);
+        throw;
+    };
+    _trackGeometry();
+}
+
+const GeometryChanges & DbEnv::GetGeometryChanges() {
+    return _geometryChanges;
+}
+
+const ReadaheadInfo & DbEnv::GetReadaheadInfo() {
+    return _readahead;
+}
+
+void DbEnv::_checkReadahead(uint64_t size) {
+    _readahead.checkedSize = size;
+
+    intptr_t pageSize = 0;
+    intptr_t totalPages = 0;
+    intptr_t availPages = 0;
+    const int ramRc = mdbx_get_sysraminfo(&pageSize, &totalPages, &availPages);
+    const std::string ram = ramRc == MDBX_SUCCESS
+        ? " (RAM available " + std::to_string(availPages * pageSize / MB) + "MB of " + std::to_string(totalPages * pageSize / MB) + "MB)"
+        : "";
+
+    const int rc = mdbx_is_readahead_reasonable((size_t) size, 0);
+    if (rc != MDBX_RESULT_TRUE && rc != MDBX_RESULT_FALSE) {
+        // Keep the previous decision.
+        _readahead.reason = std::string("readahead check failed: ") + mdbx_strerror(rc);
+        return;
+    };
+    _readahead.reasonable = rc == MDBX_RESULT_TRUE;
+    _readahead.reason = "database size " + std::to_string(size / MB) + "MB "
+        + (_readahead.reasonable ? "fits" : "doesn't fit") + " into available RAM" + ram;
+}
+
+void DbEnv::_trackGeometry() {
+    MDBX_envinfo info;
+    if (mdbx_env_info_ex(_env, NULL, &info, sizeof(info)) != MDBX_SUCCESS)
+        return;
+
+    if (_datafileSize != 0 && info.mi_geo.current > _datafileSize) {
+        _geometryChanges.grows++;
+        // With readahead enabled MDBX itself re-checks it on growth; the result is only reported.
+        if (_readahead.mode == Readahead::automatic)
+            _checkReadahead(info.mi_geo.current);
+    };
+    if (_datafileSize != 0 && info.mi_geo.current < _datafileSize)
+        _geometryChanges.shrinks++;
+    if (_mapSize != 0 && info.mi_mapsize != _mapSize)
+        _geometryChanges.remaps++;
+    _datafileSize = info.mi_geo.current;
+    _mapSize = info.mi_mapsize;
+}
+
+// Custom comparators can only be bound by mdbx_dbi_open_ex, which is deprecated in favour of key transformations
+// (changing stored keys). Comparators here keep keys as is, so the deprecation warning is suppressed for this call only.
+static int OpenDbiHandle(MDBX_txn *txn, const char *name, MDBX_db_flags_t flags, MDBX_dbi *dbi, MDBX_cmp_func *keyCmp) {
+    if (keyCmp == NULL)
+        return mdbx_dbi_open(txn, name, flags, dbi);
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable: 4996)
+#else
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+#endif
+    return mdbx_dbi_open_ex(txn, name, flags, dbi, keyCmp, NULL);
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#else
+#pragma GCC diagnostic pop
+#endif
+}
+
+int DbEnv::OpenExistingDbi(MDBX_txn *txn, const std::string &name, MDBX_dbi *dbi) {
+    if (name.empty())
+        return mdbx_dbi_open(txn, NULL, MDBX_DB_DEFAULTS, dbi);
+
+    KeyComparator keyComparator = KeyComparator::none;
+    MDBX_dbi comparatorsDbi = 0;
+    int rc = mdbx_dbi_open(txn, KEY_COMPARATORS_DBI, MDBX_DB_DEFAULTS, &comparatorsDbi);
+    if (rc == MDBX_SUCCESS) {
+        MDBX_val key;
+        key.iov_base = (void *) name.data();
+        key.iov_len = name.size();
+        MDBX_val value;
+        rc = mdbx_get(txn, comparatorsDbi, &key, &value);
+        if (rc == MDBX_SUCCESS)
+            FindKeyComparator(std::string((const char *) value.iov_base, value.iov_len), keyComparator);
+    };
+    if (rc != MDBX_SUCCESS && rc != MDBX_NOTFOUND)
+        return rc;
+
+    return OpenDbiHandle(txn, name.c_str(), MDBX_DB_ACCEDE, dbi, GetKeyComparatorFunction(keyComparator));
+}
+
+DbiInfo DbEnv::OpenDbi(const std::string &name, const DbiParameters *parameters) {
     _checkOpened();
 
     auto it = _openedDbis.find(name);
-    if (it != _openedDbis.end())
+    if (it != _openedDbis.end()) {
+        if (parameters && !(*parameters == it->second.parameters))
+            throw DbException("Dbi has already been opened with different parameters.");
         return it->second;
+    };
+
+    DbiInfo dbiInfo;
+    if (parameters)
+        dbiInfo.parameters = *parameters;
+    else
+        dbiInfo.parameters.valueMode = _valueMode;
+
+    const bool customKeyOrder = dbiInfo.parameters.reverseKey || dbiInfo.parameters.keyComparator != KeyComparator::none;
+    if (name.empty() && customKeyOrder)
+        throw DbException("Custom key order is not supported for the main dbi.");
+
+    // Slot of the service dbi is not available for named dbis.
+    if (!name.empty() && _countNamedDbis() >= _maxDbs)
+        CheckMdbxResult(MDBX_DBS_FULL);
 
     int rc = MDBX_SUCCESS;
     MDBX_dbi dbi = 0;
@@ -76,6 +539,7 @@ MDBX_dbi DbEnv::OpenDbi(const std::string &name) {
 
     try {
         if (_txn == NULL) {
+            _checkNotBusy();
             MDBX_txn_flags_t txnFlags = MDBX_TXN_READWRITE;
             if (_readOnly)
                 txnFlags |= MDBX_TXN_RDONLY;
@@ -83,12 +547,25 @@ MDBX_dbi DbEnv::OpenDbi(const std::string &name) {
             CheckMdbxResult(rc);
         };
 
+        MDBX_txn *dbTxn = (_txn != NULL) ? _txn : txn;
+
+        // Comparator is bound to the handle for the whole environment, so it is checked before opening.
+        const KeyComparator keyComparator = dbiInfo.parameters.keyComparator;
+        const bool recordComparator = !name.empty() && _checkKeyComparator(dbTxn, name, keyComparator);
+
         MDBX_db_flags_t dbFlags = MDBX_DB_DEFAULTS;
         if (!_readOnly)
             dbFlags = MDBX_CREATE;
-        rc = mdbx_dbi_open((_txn != NULL) ? _txn : txn, name.empty() ? NULL : name.c_str(), dbFlags, &dbi);
+        if (dbiInfo.parameters.reverseKey)
+            dbFlags |= MDBX_REVERSEKEY;
+        rc = OpenDbiHandle(dbTxn, name.empty() ? NULL : name.c_str(), dbFlags, &dbi, GetKeyComparatorFunction(keyComparator));
         CheckMdbxResult(rc);
 
+        if (recordComparator)
+            _recordKeyComparator(dbTxn, name, keyComparator);
+        if (dbiInfo.parameters.compression != Compression::none && dbiInfo.parameters.valueMode == ValueMode::buffer)
+            _checkCompression(dbTxn, name, dbi);
+
         if (_txn == NULL) {
             rc = mdbx_txn_commit(txn);
             CheckMdbxResult(rc);
@@ -99,19 +576,163 @@ MDBX_dbi DbEnv::OpenDbi(const std::string &name) {
         throw;
     };
 
-    _openedDbis.emplace(name, dbi);
+    dbiInfo.dbi = dbi;
+    _openedDbis.emplace(name, dbiInfo);
     if (_txn != NULL)
         _pendingTransactionDbis.insert(name);
-    return dbi;
+    return dbiInfo;
+}
+
+void DbEnv::OpenDbis(const std::vector<std::pair<std::string, DbiParameters>> &dbis) {
+    if (dbis.empty())
+        return;
+    _checkOpened();
+    _checkNotTransaction();
+
+    BeginTransaction();
+    try {
+        for (const auto &dbi : dbis)
+            OpenDbi(dbi.first, &dbi.second);
+        CommitTransaction();
+    } catch(...) {
+        if (_txn)
+            AbortTransaction();
+        throw;
+    };
 }
 
 void DbEnv::ClearDbi(const std::string &name, bool remove) {
     _checkTransaction();
-    MDBX_dbi dbi = OpenDbi(name);
+    MDBX_dbi dbi = OpenDbi(name).dbi;
     if (remove)
-        _openedDbis.erase(name);
+        _forgetDbi(name);
+    _writeBuffer.Discard(dbi);
     const int rc = mdbx_drop(_txn, dbi, remove);
     CheckMdbxResult(rc);
+    if (remove && !name.empty())
+        _forgetKeyComparator(_txn, name);
+}
+
+// Returns true if the comparator should be recorded (dbi is going to be created with it).
+bool DbEnv::_checkKeyComparator(MDBX_txn *txn, const std::string &name, KeyComparator keyComparator) {
+    MDBX_val key;
+    key.iov_base = (void *) name.data();
+    key.iov_len = name.size();
+    MDBX_val value;
+
+    MDBX_dbi comparatorsDbi = 0;
+    int rc = mdbx_dbi_open(txn, KEY_COMPARATORS_DBI, MDBX_DB_DEFAULTS, &comparatorsDbi);
+    if (rc != MDBX_NOTFOUND) {
+        CheckMdbxResult(rc);
+        rc = mdbx_get(txn, comparatorsDbi, &key, &value);
+        if (rc != MDBX_NOTFOUND) {
+            CheckMdbxResult(rc);
+            const std::string recordedName((const char *) value.iov_base, value.iov_len);
+            if (recordedName != GetKeyComparatorName(keyComparator))
+                throw DbException("Dbi '" + name + "' has been created with '" + recordedName + "' key comparator.");
+            return false;
+        };
+    };
+
+    if (keyComparator == KeyComparator::none)
+        return false;
+
+    // Named dbis are records of the main one; existing dbi without recorded comparator has keys in default order.
+    MDBX_dbi mainDbi = 0;
+    rc = mdbx_dbi_open(txn, NULL, MDBX_DB_DEFAULTS, &mainDbi);
+    CheckMdbxResult(rc);
+    rc = mdbx_get(txn, mainDbi, &key, &value);
+    if (rc != MDBX_NOTFOUND) {
+        CheckMdbxResult(rc);
+        throw DbException("Dbi '" + name + "' has been created with default key order.");
+    };
+    return !_readOnly;
+}
+
+void DbEnv::_recordKeyComparator(MDBX_txn *txn, const std::string &name, KeyComparator keyComparator) {
+    MDBX_dbi comparatorsDbi = 0;
+    int rc = mdbx_dbi_open(txn, KEY_COMPARATORS_DBI, MDBX_CREATE, &comparatorsDbi);
+    CheckMdbxResult(rc);
+
+    MDBX_val key;
+    key.iov_base = (void *) name.data();
+    key.iov_len = name.size();
+    const char *comparatorName = GetKeyComparatorName(keyComparator);
+    MDBX_val value;
+    value.iov_base = (void *) comparatorName;
+    value.iov_len = std::strlen(comparatorName);
+    rc = mdbx_put(txn, comparatorsDbi, &key, &value, MDBX_UPSERT);
+    CheckMdbxResult(rc);
+}
+
+static std::string CompressionRecordKey(const std::string &name) {
+    return name + std::string(COMPRESSION_RECORD_SUFFIX, sizeof(COMPRESSION_RECORD_SUFFIX) - 1);
+}
+
+// Raw buffers written without compression may start with the compression marker and then be misread,
+// so compression could be enabled only for a 'buffer' dbi which is empty or has been compressed since creation.
+void DbEnv::_checkCompression(MDBX_txn *txn, const std::string &name, MDBX_dbi dbi) {
+    if (_maxDbs == 0)
+        throw DbException("Compression for dbis with 'buffer' valueMode needs the service dbi; maxDbs should be positive.");
+
+    const std::string recordKey = CompressionRecordKey(name);
+    MDBX_val key;
+    key.iov_base = (void *) recordKey.data();
+    key.iov_len = recordKey.size();
+    MDBX_val value;
+
+    MDBX_dbi comparatorsDbi = 0;
+    int rc = mdbx_dbi_open(txn, KEY_COMPARATORS_DBI, MDBX_DB_DEFAULTS, &comparatorsDbi);
+    if (rc != MDBX_NOTFOUND) {
+        CheckMdbxResult(rc);
+        rc = mdbx_get(txn, comparatorsDbi, &key, &value);
+        if (rc != MDBX_NOTFOUND) {
+            CheckMdbxResult(rc);
+            return;
+        };
+    };
+
+    MDBX_stat stat;
+    rc = mdbx_dbi_stat(txn, dbi, &stat, sizeof(stat));
+    CheckMdbxResult(rc);
+    if (stat.ms_entries != 0)
+        throw DbException("Compression can't be enabled for non-empty dbi '" + name + "' with 'buffer' valueMode.");
+    if (_readOnly)
+        return;
+
+    rc = mdbx_dbi_open(txn, KEY_COMPARATORS_DBI, MDBX_CREATE, &comparatorsDbi);
+    CheckMdbxResult(rc);
+    value.iov_base = NULL;
+    value.iov_len = 0;
+    rc = mdbx_put(txn, comparatorsDbi, &key, &value, MDBX_UPSERT);
+    CheckMdbxResult(rc);
+}
+
+unsigned DbEnv::_countNamedDbis() {
+    unsigned count = 0;
+    for (const auto &item : _openedDbis) {
+        if (!item.first.empty())
+            count++;
+    };
+    return count;
+}
+
+void DbEnv::_forgetKeyComparator(MDBX_txn *txn, const std::string &name) {
+    MDBX_dbi comparatorsDbi = 0;
+    int rc = mdbx_dbi_open(txn, KEY_COMPARATORS_DBI, MDBX_DB_DEFAULTS, &comparatorsDbi);
+    if (rc == MDBX_NOTFOUND)
+        return;
+    CheckMdbxResult(rc);
+
+    // Compression record goes along with the comparator one.
+    for (const std::string &recordKey : { name, CompressionRecordKey(name) }) {
+        MDBX_val key;
+        key.iov_base = (void *) recordKey.data();
+        key.iov_len = recordKey.size();
+        rc = mdbx_del(txn, comparatorsDbi, &key, NULL);
+        if (rc != MDBX_NOTFOUND)
+            CheckMdbxResult(rc);
+    };
 }
 
 void DbEnv::_checkOpened() {
@@ -119,9 +740,19 @@ void DbEnv::_checkOpened() {
         throw DbException("Closed.");
 }
 
-void DbEnv::BeginTransaction() {
+void DbEnv::BeginTransaction(size_t autoSplitBytes, size_t writeBufferBytes) {
     _checkNotTransaction();
+    _checkNotBusy();
+
+    {
+        LatencyTimer timer(_latencyStats, _latencyStats.GetBegin());
+        _beginTransaction();
+    };
+    _autoSplitBytes = _readOnly ? 0 : autoSplitBytes;
+    _writeBuffer.Reset(_readOnly ? 0 : writeBufferBytes);
+}
 
+void DbEnv::_beginTransaction() {
     MDBX_txn_flags_t txnFlags = MDBX_TXN_READWRITE;
     if (_readOnly)
         txnFlags |= MDBX_TXN_RDONLY;
@@ -129,26 +760,55 @@ void DbEnv::BeginTransaction() {
     CheckMdbxResult(rc);
 }
 
+// Top-level commit; durations of its phases are recorded if latencies are tracked.
+int DbEnv::_commitTransaction() {
+    if (_readOnly || !_latencyStats.IsEnabled())
+        return mdbx_txn_commit(_txn);
+
+    MDBX_commit_latency latency;
+    const int rc = mdbx_txn_commit_ex(_txn, &latency);
+    if (rc == MDBX_SUCCESS)
+        _latencyStats.RecordCommit(latency);
+    return rc;
+}
+
 void DbEnv::CommitTransaction() {
     _checkTransaction();
+    if (!_parentTxns.empty())
+        throw DbException("Nested transaction is still active.");
 
-    const int rc = mdbx_txn_commit(_txn);
+    try {
+        _writeBuffer.Apply(_txn);
+    } catch(...) {
+        AbortTransaction();
+        throw;
+    };
+
+    const int rc = _commitTransaction();
     _txn = NULL;
 
+    // Handles opened by the failed transaction are closed.
+    if (rc != MDBX_SUCCESS)
+        _forgetPendingDbis();
     _pendingTransactionDbis.clear();
 
     CheckMdbxResult(rc);
+
+    if (!_readOnly)
+        _trackGeometry();
 }
 
 void DbEnv::AbortTransaction() {
     _checkTransaction();
+    while (!_parentTxns.empty())
+        AbortNestedTransaction();
 
+    LatencyTimer timer(_latencyStats, _latencyStats.GetAbort());
     const int rc = mdbx_txn_abort(_txn);
     _txn = NULL;
+    _writeBuffer.Reset(0);
 
-    for (const auto &name : _pendingTransactionDbis)
-        _openedDbis.erase(name);
-
+    _forgetPendingDbis();
     _pendingTransactionDbis.clear();
 
     CheckMdbxResult(rc);
@@ -158,22 +818,215 @@ bool DbEnv::HasTransaction() {
     return _txn != NULL;
 }
 
+// MDBX doesn't support nested transactions in MDBX_WRITEMAP mode.
+bool DbEnv::SupportsNestedTransactions() {
+    return !_readOnly && !_writeMap;
+}
+
+void DbEnv::BeginNestedTransaction() {
+    _checkTransaction();
+    if (!SupportsNestedTransactions())
+        throw DbException("Nested transactions are not supported in read-only and writeMap modes.");
+
+    // Buffered writes belong to the parent transaction.
+    _writeBuffer.Apply(_txn);
+
+    MDBX_txn *txn = NULL;
+    const int rc = mdbx_txn_begin(_env, _txn, MDBX_TXN_READWRITE, &txn);
+    CheckMdbxResult(rc);
+
+    _parentTxns.push_back(_txn);
+    _parentPendingDbis.push_back(std::move(_pendingTransactionDbis));
+    _pendingTransactionDbis.clear();
+    _txn = txn;
+}
+
+void DbEnv::CommitNestedTransaction() {
+    _checkNestedTransaction();
+
+    try {
+        _writeBuffer.Apply(_txn);
+    } catch(...) {
+        AbortNestedTransaction();
+        throw;
+    };
+
+    // Nested transaction is freed even if commit fails.
+    const int rc = mdbx_txn_commit(_txn);
+    _popNestedTransaction(rc == MDBX_SUCCESS);
+    CheckMdbxResult(rc);
+}
+
+void DbEnv::AbortNestedTransaction() {
+    _checkNestedTransaction();
+
+    const int rc = mdbx_txn_abort(_txn);
+    _writeBuffer.Clear();
+    _popNestedTransaction(false);
+    CheckMdbxResult(rc);
+}
+
+void DbEnv::_popNestedTransaction(bool committed) {
+    _txn = _parentTxns.back();
+    _parentTxns.pop_back();
+
+    std::set<std::string> parentPendingDbis = std::move(_parentPendingDbis.back());
+    _parentPendingDbis.pop_back();
+    if (committed) {
+        parentPendingDbis.insert(_pendingTransactionDbis.begin(), _pendingTransactionDbis.end());
+    } else {
+        _forgetPendingDbis();
+    };
+    _pendingTransactionDbis = std::move(parentPendingDbis);
+}
+
 MDBX_txn * DbEnv::GetTransaction() {
     _checkTransaction();
     return _txn;
 }
 
+size_t DbEnv::GetDirtyBytes() {
+    _checkTransaction();
+
+    MDBX_txn_info info;
+    const int rc = mdbx_txn_info(_txn, &info, false);
+    CheckMdbxResult(rc);
+    return _readOnly ? 0 : (size_t) info.txn_space_dirty;
+}
+
+// Only the top-level transaction could be split.
+bool DbEnv::NeedsSplit() {
+    return _autoSplitBytes != 0 && _parentTxns.empty() && GetDirtyBytes() >= _autoSplitBytes;
+}
+
+// Dbi handles remain valid: they are bound to the environment, not to the transaction.
+void DbEnv::SplitTransaction() {
+    _checkTransaction();
+
+    _writeBuffer.Apply(_txn);
+    const int rc = _commitTransaction();
+    _txn = NULL;
+    if (rc != MDBX_SUCCESS)
+        _forgetPendingDbis();
+    _pendingTransactionDbis.clear();
+    CheckMdbxResult(rc);
+    _trackGeometry();
+
+    _beginTransaction();
+}
+
+void DbEnv::AfterWrite() {
+    if (NeedsSplit())
+        SplitTransaction();
+}
+
+bool DbEnv::IsWriteBuffered() {
+    return _txn != NULL && _writeBuffer.IsEnabled();
+}
+
+void DbEnv::BufferWrite(MDBX_dbi dbi, MDBX_cmp_func *keyCmp, const MDBX_val &key, const MDBX_val *value) {
+    _checkTransaction();
+
+    _writeBuffer.Put(dbi, keyCmp, key, value);
+    if (_writeBuffer.IsFull()) {
+        FlushWriteBuffer();
+        AfterWrite();
+    };
+}
+
+const WriteBuffer::Value * DbEnv::FindBufferedWrite(MDBX_dbi dbi, const MDBX_val &key) {
+    return _writeBuffer.Find(dbi, key);
+}
+
+bool DbEnv::HasBufferedWrites(MDBX_dbi dbi) {
+    return _txn != NULL && _writeBuffer.HasWrites(dbi);
+}
+
+void DbEnv::FlushWriteBuffer(MDBX_dbi dbi) {
+    if (_txn != NULL)
+        _writeBuffer.Apply(_txn, dbi);
+}
+
+void DbEnv::FlushWriteBuffer() {
+    if (_txn != NULL)
+        _writeBuffer.Apply(_txn);
+}
+
 bool DbEnv::IsStale(const std::string &name, MDBX_dbi dbi) {
     auto it = _openedDbis.find(name);
-    return it == _openedDbis.end() || it->second != dbi;
+    return it == _openedDbis.end() || it->second.dbi != dbi;
+}
+
+bool DbEnv::IsDbiOpenedWith(const std::string &name, const DbiParameters &parameters) {
+    auto it = _openedDbis.find(name);
+    return it != _openedDbis.end() && it->second.parameters == parameters;
+}
+
+uint32_t DbEnv::GetDbiGeneration() {
+    return *_dbiGeneration;
+}
+
+void DbEnv::SetDbiGenerationStorage(uint32_t *storage) {
+    uint32_t *generation = storage ? storage : &_dbiGenerationValue;
+    *generation = *_dbiGeneration;
+    _dbiGeneration = generation;
+}
+
+void DbEnv::_forgetDbi(const std::string &name) {
+    if (_openedDbis.erase(name))
+        ++*_dbiGeneration;
+}
+
+void DbEnv::_forgetPendingDbis() {
+    for (const auto &name : _pendingTransactionDbis)
+        _forgetDbi(name);
 }
 
 bool DbEnv::IsStringKeyMode() {
     return _stringKeyMode;
 }
 
-bool DbEnv::IsStringValueMode() {
-    return _stringValueMode;
+ValueMode DbEnv::GetValueMode() {
+    return _valueMode;
+}
+
+MDBX_env * DbEnv::GetEnv() {
+    _checkOpened();
+    return _env;
+}
+
+PeriodicSyncStats DbEnv::GetPeriodicSyncStats() {
+    return _periodicSync.GetStats();
+}
+
+LatencyStats & DbEnv::GetLatencyStats() {
+    return _latencyStats;
+}
+
+void DbEnv::SetBusy(bool busy) {
+    _busy = busy;
+}
+
+bool DbEnv::IsBusy() {
+    return _busy;
+}
+
+void DbEnv::AddBackgroundReader() {
+    _checkOpened();
+    _backgroundReaders++;
+}
+
+void DbEnv::ReleaseBackgroundReader() {
+    _backgroundReaders--;
+}
+
+bool DbEnv::IsInUse() {
+    return _busy || _backgroundReaders > 0;
+}
+
+void DbEnv::_checkNotBusy() {
+    if (_busy)
+        throw DbException("Database is busy with a background operation.");
 }
 
 void DbEnv::_checkTransaction() {
@@ -181,11 +1034,19 @@ void DbEnv::_checkTransaction() {
         throw DbException("No transaction started.");
 }
 
+void DbEnv::_checkNestedTransaction() {
+    if (_parentTxns.empty())
+        throw DbException("No nested transaction started.");
+}
+
 void DbEnv::_checkNotTransaction() {
     if (_txn != NULL)
         throw DbException("Multiple parallel transactions.");
 }
 
 DbEnv::~DbEnv() {
+    // Nobody else holds the environment here, so no background operation can run.
+    _busy = false;
+    _backgroundReaders = 0;
     Close();
 }
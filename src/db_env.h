@@ -4,11 +4,18 @@
 #include <string>
 #include <map>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
 #include "mdbx.h"
 #include "utils.h"
 
 #include "db_exception.h"
+#include "compression.h"
+#include "comparators.h"
+#include "write_buffer.h"
+#include "periodic_sync.h"
+#include "latency_stats.h"
 
 const intptr_t MB = 1048576;
 
@@ -23,14 +30,106 @@ enum class SyncMode {
     unsafe = MDBX_NOMETASYNC | MDBX_UTTERLY_NOSYNC
 };
 
+enum class ValueMode {
+    buffer = 0,
+    string,
+    msgpack
+};
+
+enum class Readahead {
+    on = 0,
+    off,
+    automatic
+};
+
+struct ReadaheadInfo {
+    Readahead mode = Readahead::on;
+    // MDBX_NORDAHEAD can only be set when the environment is opened.
+    bool enabled = true;
+    // Result of the last mdbx_is_readahead_reasonable check.
+    bool reasonable = true;
+    uint64_t checkedSize = 0;
+    std::string reason;
+};
+
+// Sizes are in bytes; -1 means default (or current value for SetGeometry).
+struct DbGeometry {
+    intptr_t sizeLower = -1;
+    intptr_t sizeNow = -1;
+    intptr_t sizeUpper = 256 * 1024 * MB;
+    intptr_t growthStep = 4 * MB;
+    intptr_t shrinkThreshold = 16 * MB;
+};
+
+// Changes of the datafile size and the memory map observed at commits.
+struct GeometryChanges {
+    uint64_t grows = 0;
+    uint64_t shrinks = 0;
+    uint64_t remaps = 0;
+};
+
+// Free pages (retired by transactions and recorded in GC) and the space they occupy.
+struct GcInfo {
+    uint64_t pageSize = 0;
+    // Pages of the datafile, used (allocated up to the last one) and unallocated at its end.
+    uint64_t totalPages = 0;
+    uint64_t usedPages = 0;
+    // GC records (one per transaction which has retired pages) and pages of GC tree itself.
+    uint64_t gcEntries = 0;
+    uint64_t gcTreePages = 0;
+    uint64_t freePages = 0;
+    // Free pages which can be reused now / retired after the oldest snapshot in use.
+    uint64_t reclaimablePages = 0;
+    uint64_t pinnedPages = 0;
+    uint64_t lastTxnWithFreePages = 0;
+    uint64_t oldestReaderTxnId = 0;
+    uint64_t recentTxnId = 0;
+    // Whether free pages are counted (GC table has been walked).
+    bool walked = true;
+};
+
+struct DbiParameters {
+    ValueMode valueMode = ValueMode::buffer;
+    Compression compression = Compression::none;
+    size_t compressionThreshold = 256;
+    size_t internKeys = 0;
+    bool reverseKey = false;
+    KeyComparator keyComparator = KeyComparator::none;
+
+    bool operator==(const DbiParameters &other) const {
+        return valueMode == other.valueMode
+            && compression == other.compression
+            && compressionThreshold == other.compressionThreshold
+            && internKeys == other.internKeys
+            && reverseKey == other.reverseKey
+            && keyComparator == other.keyComparator;
+    }
+};
+
 struct DbEnvParameters {
     std::string dbPath;
     bool readOnly = false;
     intptr_t pageSize = -1;
     unsigned maxDbs = 0;
     bool stringKeyMode = true;
-    bool stringValueMode = false;
+    ValueMode valueMode = ValueMode::buffer;
     SyncMode syncMode = SyncMode::durable;
+    bool writeMap = false;
+    Readahead readahead = Readahead::on;
+    DbGeometry geometry;
+    // Interval (in milliseconds) of background flushes; 0 - disabled.
+    unsigned syncInterval = 0;
+    // Each latencySampling-th operation of dbis is measured (see LatencyStats); 0 - disabled.
+    unsigned latencySampling = 0;
+    // Engine options (mdbx_env_set_option) applied when the environment is opened.
+    std::vector<std::pair<MDBX_option_t, uint64_t>> options;
+    // Dbis opened (and created if needed) in a single transaction when the environment is opened.
+    std::vector<std::pair<std::string, DbiParameters>> dbis;
+};
+
+struct DbiInfo {
+    MDBX_dbi dbi = 0;
+    DbiParameters parameters;
 };
 
 class DbEnv {
@@ -40,30 +139,128 @@ public:
     bool IsOpened();
     bool IsReadOnly();
 
-    MDBX_dbi OpenDbi(const std::string &name);
+    // Opens handle of existing dbi (empty name - the main one) binding the key comparator recorded for it,
+    // so that the handle is compatible with OpenDbi. Doesn't depend on the state of DbEnv.
+    static int OpenExistingDbi(MDBX_txn *txn, const std::string &name, MDBX_dbi *dbi);
+    // Engine tuning options by name, e.g. "txnDpLimit" for MDBX_opt_txn_dp_limit.
+    static bool FindOption(const std::string &name, MDBX_option_t &option);
+    static std::vector<std::string> GetOptionNames();
+    // Options are given in units of their names (e.g. milliseconds of "syncPeriodMs") and converted for MDBX.
+    static uint64_t OptionToMdbx(MDBX_option_t option, double value);
+    static double OptionFromMdbx(MDBX_option_t option, uint64_t value);
+    void SetOption(MDBX_option_t option, uint64_t value);
+    uint64_t GetOption(MDBX_option_t option);
+
+    void SetGeometry(const DbGeometry &geometry);
+    MDBX_envinfo GetInfo();
+    // Walks GC table (inside the current transaction if any; only its stats are taken inside a write one).
+    GcInfo GetGcInfo();
+    // Returns unused space at the end of the datafile to the filesystem (size is reduced down to the used pages).
+    void Shrink();
+    // Whether the environment is opened by other processes as well.
+    bool IsUsedByOtherProcesses();
+    const GeometryChanges & GetGeometryChanges();
+    const ReadaheadInfo & GetReadaheadInfo();
+
+    // Parameters are applied when dbi is opened for the first time; afterwards they should match (if given).
+    DbiInfo OpenDbi(const std::string &name, const DbiParameters *parameters = NULL);
+    // Opens several dbis in one (write if possible) transaction.
+    void OpenDbis(const std::vector<std::pair<std::string, DbiParameters>> &dbis);
     void ClearDbi(const std::string &name, bool remove);
 
-    void BeginTransaction();
+    // With non-zero autoSplitBytes the transaction is committed and started again
+    // each time its dirty pages exceed the threshold (see AfterWrite).
+    // With non-zero writeBufferBytes puts and deletes may be buffered (see BufferWrite).
+    void BeginTransaction(size_t autoSplitBytes = 0, size_t writeBufferBytes = 0);
     void CommitTransaction();
     void AbortTransaction();
     bool HasTransaction();
+
+    // Nested transactions are children of the current one (not supported in read-only and writeMap modes).
+    bool SupportsNestedTransactions();
+    void BeginNestedTransaction();
+    void CommitNestedTransaction();
+    void AbortNestedTransaction();
     MDBX_txn * GetTransaction();
+    size_t GetDirtyBytes();
+    bool NeedsSplit();
+    void SplitTransaction();
+    void AfterWrite();
+
+    bool IsWriteBuffered();
+    // NULL value means deletion. Buffer is applied when it is full, at commit or by FlushWriteBuffer.
+    void BufferWrite(MDBX_dbi dbi, MDBX_cmp_func *keyCmp, const MDBX_val &key, const MDBX_val *value);
+    const WriteBuffer::Value * FindBufferedWrite(MDBX_dbi dbi, const MDBX_val &key);
+    bool HasBufferedWrites(MDBX_dbi dbi);
+    void FlushWriteBuffer(MDBX_dbi dbi);
+    void FlushWriteBuffer();
     bool IsStale(const std::string &name, MDBX_dbi dbi);
+    // True if dbi is opened with the same parameters, so that OpenDbi would return it as is.
+    bool IsDbiOpenedWith(const std::string &name, const DbiParameters &parameters);
+    // Generation of opened dbis is incremented each time some dbi handles become stale, so that
+    // handles cached before could be revalidated by a single comparison. Counter could be placed
+    // into external storage (e.g. memory shared with JS); NULL returns it into the environment.
+    uint32_t GetDbiGeneration();
+    void SetDbiGenerationStorage(uint32_t *storage);
     bool IsStringKeyMode();
-    bool IsStringValueMode();
+    ValueMode GetValueMode();
+
+    // Background operations (running on worker threads with their own write transactions)
+    // mark environment as busy: no transactions can be started and it can't be closed meanwhile.
+    MDBX_env * GetEnv();
+    void SetBusy(bool busy);
+    bool IsBusy();
+    // Background read-only operations (e.g. copying) run with their own read transactions and don't block
+    // transactions of the environment, but it can't be closed meanwhile either.
+    void AddBackgroundReader();
+    void ReleaseBackgroundReader();
+    bool IsInUse();
+
+    PeriodicSyncStats GetPeriodicSyncStats();
+    LatencyStats & GetLatencyStats();
 
     ~DbEnv();
 
 private:
     void _checkTransaction();
     void _checkNotTransaction();
+    void _checkNestedTransaction();
+    void _trackGeometry();
+    void _checkReadahead(uint64_t size);
+    void _popNestedTransaction(bool committed);
+    void _beginTransaction();
+    int _commitTransaction();
     void _checkOpened();
+    void _checkNotBusy();
+    bool _checkKeyComparator(MDBX_txn *txn, const std::string &name, KeyComparator keyComparator);
+    void _recordKeyComparator(MDBX_txn *txn, const std::string &name, KeyComparator keyComparator);
+    void _checkCompression(MDBX_txn *txn, const std::string &name, MDBX_dbi dbi);
+    void _forgetKeyComparator(MDBX_txn *txn, const std::string &name);
+    unsigned _countNamedDbis();
+    void _forgetDbi(const std::string &name);
+    void _forgetPendingDbis();
 
     bool _readOnly = false;
+    unsigned _maxDbs = 0;
+    bool _writeMap = false;
+    uint64_t _datafileSize = 0;
+    uint64_t _mapSize = 0;
+    GeometryChanges _geometryChanges;
+    ReadaheadInfo _readahead;
+    PeriodicSync _periodicSync;
+    LatencyStats _latencyStats;
+    bool _busy = false;
+    unsigned _backgroundReaders = 0;
     bool _stringKeyMode = true;
-    bool _stringValueMode = false;
+    ValueMode _valueMode = ValueMode::buffer;
     MDBX_env *_env = NULL;
     MDBX_txn *_txn = NULL;
-    std::map<std::string, MDBX_dbi> _openedDbis;
+    size_t _autoSplitBytes = 0;
+    WriteBuffer _writeBuffer;
+    std::unordered_map<std::string, DbiInfo> _openedDbis;
+    uint32_t _dbiGenerationValue = 0;
+    uint32_t *_dbiGeneration = &_dbiGenerationValue;
     std::set<std::string> _pendingTransactionDbis;
+    std::vector<MDBX_txn *> _parentTxns;
+    std::vector<std::set<std::string>> _parentPendingDbis;
 };
\ No newline at end of file
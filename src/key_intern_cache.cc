@@ -0,0 +1,41 @@
+#include "key_intern_cache.h"
+
+KeyInternCache::KeyInternCache(Napi::Env env, size_t capacity) {
+    _slots = Napi::Persistent(Napi::Array::New(env, capacity).As<Napi::Object>());
+    _index.reserve(capacity);
+    _stats.capacity = capacity;
+}
+
+Napi::Value KeyInternCache::Get(Napi::Env env, const MDBX_val &key) {
+    const std::string_view bytes((const char *) key.iov_base, key.iov_len);
+
+    auto it = _index.find(bytes);
+    if (it != _index.end()) {
+        _stats.hits++;
+        _entries.splice(_entries.begin(), _entries, it->second);
+        return _slots.Value().Get(it->second->slot);
+    };
+
+    _stats.misses++;
+    Napi::String result = Napi::String::New(env, bytes.data(), bytes.size());
+
+    uint32_t slot = (uint32_t) _entries.size();
+    if (_entries.size() >= _stats.capacity) {
+        Entries::iterator last = std::prev(_entries.end());
+        slot = last->slot;
+        _index.erase(last->bytes);
+        _entries.erase(last);
+        _stats.evictions++;
+    };
+
+    _entries.push_front(Entry{ std::string(bytes), slot });
+    _index.emplace(_entries.front().bytes, _entries.begin());
+    _slots.Value().Set(slot, result);
+    _stats.size = _entries.size();
+
+    return result;
+}
+
+const KeyInternCache::Stats & KeyInternCache::GetStats() {
+    return _stats;
+}
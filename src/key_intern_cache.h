@@ -0,0 +1,44 @@
+#pragma once
+
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <memory>
+
+#include <napi.h>
+#include "mdbx.h"
+
+// LRU cache of JS strings created for keys, so repeated scans over the same keys
+// return existing strings instead of allocating new ones.
+class KeyInternCache {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t size = 0;
+        size_t capacity = 0;
+    };
+
+    KeyInternCache(Napi::Env env, size_t capacity);
+
+    Napi::Value Get(Napi::Env env, const MDBX_val &key);
+    const Stats & GetStats();
+
+private:
+    struct Entry {
+        std::string bytes;
+        uint32_t slot;
+    };
+
+    typedef std::list<Entry> Entries;
+
+    // Strings are kept in a JS array: references to primitive values are not supported by older N-API versions.
+    Napi::ObjectReference _slots;
+    Entries _entries;
+    std::unordered_map<std::string_view, Entries::iterator> _index;
+    Stats _stats;
+};
+
+typedef std::shared_ptr<KeyInternCache> KeyInternCachePtr;
@@ -0,0 +1,171 @@
+#include "latency_stats.h"
+
+#include <algorithm>
+
+void LatencyHistogram::Record(uint64_t value) {
+    if (_counts.empty())
+        _counts.resize(BUCKETS, 0);
+    _counts[_bucketIndex(value)]++;
+
+    _min = (_count == 0) ? value : std::min(_min, value);
+    _max = std::max(_max, value);
+    _sum += value;
+    _count++;
+}
+
+void LatencyHistogram::Reset() {
+    _counts.clear();
+    _count = 0;
+    _sum = 0;
+    _min = 0;
+    _max = 0;
+}
+
+uint64_t LatencyHistogram::GetCount() const {
+    return _count;
+}
+
+uint64_t LatencyHistogram::GetMin() const {
+    return _min;
+}
+
+uint64_t LatencyHistogram::GetMax() const {
+    return _max;
+}
+
+double LatencyHistogram::GetMean() const {
+    return _count ? (double) _sum / _count : 0.0;
+}
+
+uint64_t LatencyHistogram::GetPercentile(double percentile) const {
+    if (_count == 0)
+        return 0;
+
+    const double rank = std::max(1.0, percentile / 100.0 * _count);
+    uint64_t seen = 0;
+    for (unsigned index = 0; index < _counts.size(); index++) {
+        seen += _counts[index];
+        if (seen >= rank)
+            return (index == BUCKETS - 1) ? _max : std::min(_bucketUpperBound(index), _max);
+    };
+    return _max;
+}
+
+// Values below SUB_BUCKETS are counted exactly; each next power of 2 is split into SUB_BUCKETS parts.
+unsigned LatencyHistogram::_bucketIndex(uint64_t value) {
+    if (value < SUB_BUCKETS)
+        return (unsigned) value;
+
+    unsigned exponent = 63;
+    while (!(value >> exponent))
+        exponent--;
+    if (exponent >= MAX_BITS)
+        return BUCKETS - 1;
+
+    const unsigned shift = exponent - SUB_BUCKET_BITS;
+    return SUB_BUCKETS + shift * SUB_BUCKETS + (unsigned) ((value >> shift) & (SUB_BUCKETS - 1));
+}
+
+uint64_t LatencyHistogram::_bucketUpperBound(unsigned index) {
+    if (index < SUB_BUCKETS)
+        return index;
+
+    const unsigned shift = (index - SUB_BUCKETS) / SUB_BUCKETS;
+    const uint64_t subBucket = (index - SUB_BUCKETS) % SUB_BUCKETS;
+    return ((SUB_BUCKETS + subBucket + 1) << shift) - 1;
+}
+
+void LatencyStats::SetSampleRate(unsigned sampleRate) {
+    _sampleRate = sampleRate;
+    _sampleCounter = 0;
+}
+
+unsigned LatencyStats::GetSampleRate() const {
+    return _sampleRate;
+}
+
+bool LatencyStats::IsEnabled() const {
+    return _sampleRate != 0;
+}
+
+bool LatencyStats::Sample() {
+    if (_sampleRate == 0)
+        return false;
+    if (++_sampleCounter < _sampleRate)
+        return false;
+    _sampleCounter = 0;
+    return true;
+}
+
+DbiLatency * LatencyStats::GetDbiLatency(const std::string &name) {
+    return &_dbis[name];
+}
+
+const std::map<std::string, DbiLatency> & LatencyStats::GetDbis() const {
+    return _dbis;
+}
+
+LatencyHistogram & LatencyStats::GetBegin() {
+    return _begin;
+}
+
+const LatencyHistogram & LatencyStats::GetBegin() const {
+    return _begin;
+}
+
+LatencyHistogram & LatencyStats::GetAbort() {
+    return _abort;
+}
+
+const LatencyHistogram & LatencyStats::GetAbort() const {
+    return _abort;
+}
+
+const CommitLatency & LatencyStats::GetCommit() const {
+    return _commit;
+}
+
+// Durations of MDBX_commit_latency are in 1/65536 of second.
+static uint64_t CommitDuration(uint32_t value) {
+    return ((uint64_t) value * 1000000000) >> 16;
+}
+
+void LatencyStats::RecordCommit(const MDBX_commit_latency &latency) {
+    _commit.preparation.Record(CommitDuration(latency.preparation));
+    _commit.gc.Record(CommitDuration(latency.gc));
+    _commit.write.Record(CommitDuration(latency.write));
+    _commit.sync.Record(CommitDuration(latency.sync));
+    _commit.ending.Record(CommitDuration(latency.ending));
+    _commit.whole.Record(CommitDuration(latency.whole));
+}
+
+void LatencyStats::Reset() {
+    for (auto &dbi : _dbis) {
+        for (auto &histogram : dbi.second)
+            histogram.Reset();
+    };
+    _begin.Reset();
+    _abort.Reset();
+    _commit = CommitLatency();
+}
+
+LatencyTimer::LatencyTimer(LatencyStats &stats, LatencyHistogram &histogram) {
+    if (stats.IsEnabled()) {
+        _histogram = &histogram;
+        _start = std::chrono::steady_clock::now();
+    };
+}
+
+LatencyTimer::LatencyTimer(LatencyStats &stats, DbiLatency *dbiLatency, LatencyOp op) {
+    if (dbiLatency && stats.Sample()) {
+        _histogram = &(*dbiLatency)[(size_t) op];
+        _start = std::chrono::steady_clock::now();
+    };
+}
+
+LatencyTimer::~LatencyTimer() {
+    if (_histogram) {
+        const auto duration = std::chrono::steady_clock::now() - _start;
+        _histogram->Record((uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+    };
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+#include <array>
+
+#include "mdbx.h"
+
+// Histogram of latencies (in nanoseconds) in HDR style: buckets are powers of 2 split into
+// SUB_BUCKETS linear sub-buckets, so that the relative error doesn't exceed 1/SUB_BUCKETS at any
+// magnitude. Counters are allocated at the first record, empty histograms take no memory.
+class LatencyHistogram {
+public:
+    static const unsigned SUB_BUCKET_BITS = 4;
+    static const unsigned SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    // Values up to 2^40 ns (~18 minutes); longer ones are counted in the last bucket.
+    static const unsigned MAX_BITS = 40;
+    static const unsigned BUCKETS = SUB_BUCKETS + (MAX_BITS - SUB_BUCKET_BITS) * SUB_BUCKETS;
+
+    void Record(uint64_t value);
+    void Reset();
+
+    uint64_t GetCount() const;
+    uint64_t GetMin() const;
+    uint64_t GetMax() const;
+    double GetMean() const;
+    // Upper bound of the bucket containing the given percentile (0..100), limited by the max value.
+    uint64_t GetPercentile(double percentile) const;
+
+private:
+    static unsigned _bucketIndex(uint64_t value);
+    static uint64_t _bucketUpperBound(unsigned index);
+
+    std::vector<uint64_t> _counts;
+    uint64_t _count = 0;
+    uint64_t _sum = 0;
+    uint64_t _min = 0;
+    uint64_t _max = 0;
+};
+
+// Native operations of dbis (several methods could share the same operation type).
+enum class LatencyOp {
+    get = 0,
+    has,
+    put,
+    del,
+    delRange,
+    update,
+    cursor,
+    count
+};
+
+typedef std::array<LatencyHistogram, (size_t) LatencyOp::count> DbiLatency;
+
+// Phases of the top-level commit reported by mdbx_txn_commit_ex.
+struct CommitLatency {
+    LatencyHistogram preparation;
+    LatencyHistogram gc;
+    LatencyHistogram write;
+    LatencyHistogram sync;
+    LatencyHistogram ending;
+    LatencyHistogram whole;
+};
+
+// Latencies of native operations of the environment, per dbi and operation type.
+// Operations of dbis are sampled (each sampleRate-th of them is measured, 0 - disabled);
+// transactions are measured whenever tracking is enabled, their cost dwarfs the one of the clock.
+// Not thread-safe: used by the main thread only (background operations are not measured).
+class LatencyStats {
+public:
+    void SetSampleRate(unsigned sampleRate);
+    unsigned GetSampleRate() const;
+    bool IsEnabled() const;
+    bool Sample();
+
+    // Pointer remains valid for the lifetime of the stats, Reset only clears the histograms.
+    DbiLatency * GetDbiLatency(const std::string &name);
+    const std::map<std::string, DbiLatency> & GetDbis() const;
+
+    LatencyHistogram & GetBegin();
+    const LatencyHistogram & GetBegin() const;
+    LatencyHistogram & GetAbort();
+    const LatencyHistogram & GetAbort() const;
+    const CommitLatency & GetCommit() const;
+    void RecordCommit(const MDBX_commit_latency &latency);
+
+    void Reset();
+
+private:
+    unsigned _sampleRate = 0;
+    unsigned _sampleCounter = 0;
+    std::map<std::string, DbiLatency> _dbis;
+    LatencyHistogram _begin;
+    LatencyHistogram _abort;
+    CommitLatency _commit;
+};
+
+// Measures the scope (if sampled) and records its duration into the histogram.
+class LatencyTimer {
+public:
+    LatencyTimer(LatencyStats &stats, LatencyHistogram &histogram);
+    LatencyTimer(LatencyStats &stats, DbiLatency *dbiLatency, LatencyOp op);
+    ~LatencyTimer();
+
+private:
+    LatencyHistogram *_histogram = NULL;
+    std::chrono::steady_clock::time_point _start;
+};
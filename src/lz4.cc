@@ -0,0 +1,196 @@
+#include "lz4.h"
+
+#include <cstring>
+
+namespace {
+
+const size_t MIN_MATCH = 4;
+const size_t LAST_LITERALS = 5;
+const size_t MF_LIMIT = 12;
+const size_t MAX_DISTANCE = 65535;
+const unsigned HASH_LOG = 12;
+const unsigned SKIP_TRIGGER = 6;
+
+uint32_t Read32(const uint8_t *p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint32_t Hash(uint32_t sequence) {
+    return (sequence * 2654435761U) >> (32 - HASH_LOG);
+}
+
+uint8_t *WriteLength(uint8_t *op, size_t length) {
+    while (length >= 255) {
+        *op++ = 255;
+        length -= 255;
+    };
+    *op++ = (uint8_t) length;
+    return op;
+}
+
+// Worst case size of a sequence with given literals and match lengths.
+size_t SequenceBound(size_t literals, size_t matchLength) {
+    return 1 + literals / 255 + 1 + literals + 2 + matchLength / 255 + 1;
+}
+
+}
+
+size_t Lz4Compress(const char *src, size_t srcSize, char *dst, size_t dstCapacity) {
+    const uint8_t *const base = (const uint8_t *) src;
+    const uint8_t *const iend = base + srcSize;
+    const uint8_t *ip = base;
+    const uint8_t *anchor = base;
+    uint8_t *op = (uint8_t *) dst;
+    uint8_t *const oend = op + dstCapacity;
+
+    if (srcSize > MF_LIMIT) {
+        const uint8_t *const mfLimit = iend - MF_LIMIT;
+        const uint8_t *const matchLimit = iend - LAST_LITERALS;
+
+        uint32_t table[1 << HASH_LOG];
+        std::memset(table, 0, sizeof(table));
+
+        ip++;
+        unsigned searchCount = 1 << SKIP_TRIGGER;
+        while (ip < mfLimit) {
+            const uint32_t sequence = Read32(ip);
+            const uint32_t hash = Hash(sequence);
+            const uint8_t *ref = base + table[hash];
+            table[hash] = (uint32_t) (ip - base);
+
+            if (ref >= ip || (size_t) (ip - ref) > MAX_DISTANCE || Read32(ref) != sequence) {
+                // Incompressible data is skipped faster and faster.
+                ip += searchCount++ >> SKIP_TRIGGER;
+                continue;
+            };
+            searchCount = 1 << SKIP_TRIGGER;
+
+            while (ip > anchor && ref > base && ip[-1] == ref[-1]) {
+                ip--;
+                ref--;
+            };
+
+            const uint8_t *matchEnd = ip + MIN_MATCH;
+            const uint8_t *refEnd = ref + MIN_MATCH;
+            while (matchEnd < matchLimit && *matchEnd == *refEnd) {
+                matchEnd++;
+                refEnd++;
+            };
+
+            const size_t literals = ip - anchor;
+            const size_t matchLength = matchEnd - ip - MIN_MATCH;
+            if (SequenceBound(literals, matchLength) > (size_t) (oend - op))
+                return 0;
+
+            uint8_t *token = op++;
+            if (literals >= 15) {
+                *token = 15 << 4;
+                op = WriteLength(op, literals - 15);
+            } else {
+                *token = (uint8_t) (literals << 4);
+            };
+            std::memcpy(op, anchor, literals);
+            op += literals;
+
+            const size_t offset = ip - ref;
+            *op++ = (uint8_t) offset;
+            *op++ = (uint8_t) (offset >> 8);
+
+            if (matchLength >= 15) {
+                *token |= 15;
+                op = WriteLength(op, matchLength - 15);
+            } else {
+                *token |= (uint8_t) matchLength;
+            };
+
+            ip = anchor = matchEnd;
+            if (ip < mfLimit)
+                table[Hash(Read32(ip - 2))] = (uint32_t) (ip - 2 - base);
+        };
+    };
+
+    const size_t literals = iend - anchor;
+    if (1 + literals / 255 + 1 + literals > (size_t) (oend - op))
+        return 0;
+    if (literals >= 15) {
+        *op++ = 15 << 4;
+        op = WriteLength(op, literals - 15);
+    } else {
+        *op++ = (uint8_t) (literals << 4);
+    };
+    std::memcpy(op, anchor, literals);
+    op += literals;
+
+    return op - (uint8_t *) dst;
+}
+
+bool Lz4Decompress(const char *src, size_t srcSize, char *dst, size_t dstSize) {
+    // Empty block consists of a single token without literals.
+    if (dstSize == 0)
+        return srcSize == 1 && src[0] == 0;
+
+    const uint8_t *ip = (const uint8_t *) src;
+    const uint8_t *const iend = ip + srcSize;
+    uint8_t *const ostart = (uint8_t *) dst;
+    uint8_t *op = ostart;
+    uint8_t *const oend = op + dstSize;
+
+    while (ip < iend) {
+        const uint8_t token = *ip++;
+
+        size_t literals = token >> 4;
+        if (literals == 15) {
+            uint8_t byte;
+            do {
+                if (ip >= iend)
+                    return false;
+                byte = *ip++;
+                literals += byte;
+            } while (byte == 255);
+        };
+        if (literals > (size_t) (iend - ip) || literals > (size_t) (oend - op))
+            return false;
+        std::memcpy(op, ip, literals);
+        ip += literals;
+        op += literals;
+
+        // The last sequence contains only literals.
+        if (ip == iend)
+            break;
+
+        if (iend - ip < 2)
+            return false;
+        const size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (size_t) (op - ostart))
+            return false;
+
+        size_t matchLength = token & 15;
+        if (matchLength == 15) {
+            uint8_t byte;
+            do {
+                if (ip >= iend)
+                    return false;
+                byte = *ip++;
+                matchLength += byte;
+            } while (byte == 255);
+        };
+        matchLength += MIN_MATCH;
+        if (matchLength > (size_t) (oend - op))
+            return false;
+
+        const uint8_t *match = op - offset;
+        if (offset >= matchLength) {
+            std::memcpy(op, match, matchLength);
+            op += matchLength;
+        } else {
+            // Overlapping match repeats the last 'offset' bytes.
+            for (size_t i = 0; i < matchLength; i++)
+                *op++ = *match++;
+        };
+    };
+
+    return op == oend;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Minimal implementation of LZ4 block format (https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md).
+// Output of Lz4Compress is readable by the reference LZ4_decompress_safe and vice versa.
+
+// Returns size of compressed data or 0 if it doesn't fit into dstCapacity.
+size_t Lz4Compress(const char *src, size_t srcSize, char *dst, size_t dstCapacity);
+
+// Decompresses block of exactly dstSize bytes. Returns false on malformed input.
+bool Lz4Decompress(const char *src, size_t srcSize, char *dst, size_t dstSize);
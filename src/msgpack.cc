@@ -0,0 +1,467 @@
+#include "msgpack.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+const unsigned MAX_DEPTH = 256;
+const double MAX_SAFE_INTEGER = 9007199254740991.0;
+
+const int8_t EXT_TIMESTAMP = -1;
+// The same convention as msgpackr/msgpack-lite use for JS 'undefined'.
+const int8_t EXT_UNDEFINED = 0;
+
+template<typename T>
+T ReadBigEndian(const uint8_t *bytes) {
+    T value = 0;
+    for (size_t i = 0; i < sizeof(T); i++)
+        value = (T) ((value << 8) | bytes[i]);
+    return value;
+}
+
+class Encoder {
+public:
+    Encoder(Napi::Env env, buffer_t &to): _env(env), _to(to) {
+
+    }
+
+    void Encode(const Napi::Value &value, unsigned depth) {
+        if (depth > MAX_DEPTH)
+            throw Napi::Error::New(_env, "Value is too deep to be serialized.");
+
+        switch (value.Type()) {
+            case napi_undefined:
+                _putByte(0xd4);
+                _putByte((uint8_t) EXT_UNDEFINED);
+                _putByte(0);
+                break;
+            case napi_null:
+                _putByte(0xc0);
+                break;
+            case napi_boolean:
+                _putByte(value.As<Napi::Boolean>().Value() ? 0xc3 : 0xc2);
+                break;
+            case napi_number:
+                _encodeNumber(value.As<Napi::Number>().DoubleValue());
+                break;
+            case napi_bigint:
+                _encodeBigInt(value.As<Napi::BigInt>());
+                break;
+            case napi_string:
+                _encodeString(value);
+                break;
+            case napi_object:
+                if (value.IsArray()) {
+                    _encodeArray(value.As<Napi::Array>(), depth);
+                } else if (value.IsBuffer()) {
+                    auto buffer = value.As<Napi::Buffer<char>>();
+                    _encodeBinary(buffer.Data(), buffer.Length());
+                } else if (value.IsDate()) {
+                    _encodeDate(value.As<Napi::Date>().ValueOf());
+                } else {
+                    _encodeObject(value.As<Napi::Object>(), depth);
+                };
+                break;
+            default:
+                throw Napi::Error::New(_env, "Unsupported value type for msgpack.");
+        };
+    }
+
+private:
+    void _putByte(uint8_t byte) {
+        _to.push_back((char) byte);
+    }
+
+    template<typename T>
+    void _putBigEndian(T value) {
+        for (int shift = (sizeof(T) - 1) * 8; shift >= 0; shift -= 8)
+            _putByte((uint8_t) (value >> shift));
+    }
+
+    void _putLength(size_t length, uint8_t fix, size_t fixLimit, uint8_t len8, uint8_t len16, uint8_t len32) {
+        if (length < fixLimit) {
+            _putByte(fix | (uint8_t) length);
+        } else if (len8 != 0 && length <= 0xff) {
+            _putByte(len8);
+            _putByte((uint8_t) length);
+        } else if (length <= 0xffff) {
+            _putByte(len16);
+            _putBigEndian((uint16_t) length);
+        } else if (length <= 0xffffffff) {
+            _putByte(len32);
+            _putBigEndian((uint32_t) length);
+        } else {
+            throw Napi::Error::New(_env, "Value is too large to be serialized.");
+        };
+    }
+
+    void _encodeNumber(double number) {
+        if (std::trunc(number) != number || std::fabs(number) > MAX_SAFE_INTEGER) {
+            _putByte(0xcb);
+            uint64_t bits;
+            std::memcpy(&bits, &number, sizeof(bits));
+            _putBigEndian(bits);
+            return;
+        };
+
+        const int64_t integer = (int64_t) number;
+        _encodeInteger(integer);
+    }
+
+    void _encodeInteger(int64_t integer) {
+        if (integer >= 0) {
+            if (integer < 0x80) {
+                _putByte((uint8_t) integer);
+            } else if (integer <= 0xff) {
+                _putByte(0xcc);
+                _putByte((uint8_t) integer);
+            } else if (integer <= 0xffff) {
+                _putByte(0xcd);
+                _putBigEndian((uint16_t) integer);
+            } else if (integer <= 0xffffffff) {
+                _putByte(0xce);
+                _putBigEndian((uint32_t) integer);
+            } else {
+                _putByte(0xcf);
+                _putBigEndian((uint64_t) integer);
+            };
+        } else {
+            if (integer >= -32) {
+                _putByte((uint8_t) (int8_t) integer);
+            } else if (integer >= INT8_MIN) {
+                _putByte(0xd0);
+                _putByte((uint8_t) (int8_t) integer);
+            } else if (integer >= INT16_MIN) {
+                _putByte(0xd1);
+                _putBigEndian((uint16_t) (int16_t) integer);
+            } else if (integer >= INT32_MIN) {
+                _putByte(0xd2);
+                _putBigEndian((uint32_t) (int32_t) integer);
+            } else {
+                _putByte(0xd3);
+                _putBigEndian((uint64_t) integer);
+            };
+        };
+    }
+
+    void _encodeBigInt(const Napi::BigInt &value) {
+        bool lossless = false;
+        const int64_t integer = value.Int64Value(&lossless);
+        if (lossless) {
+            _encodeInteger(integer);
+            return;
+        };
+
+        const uint64_t unsignedInteger = value.Uint64Value(&lossless);
+        if (!lossless)
+            throw Napi::Error::New(_env, "BigInt is out of 64-bit range.");
+        _putByte(0xcf);
+        _putBigEndian(unsignedInteger);
+    }
+
+    void _encodeString(const Napi::Value &value) {
+        size_t length = 0;
+        napi_status status = napi_get_value_string_utf8(_env, value, NULL, 0, &length);
+        if (status != napi_ok)
+            throw Napi::Error::New(_env);
+
+        _putLength(length, 0xa0, 32, 0xd9, 0xda, 0xdb);
+
+        // UTF-8 bytes are written straight into the output buffer (with a room for terminating zero).
+        const size_t offset = _to.size();
+        _to.resize(offset + length + 1);
+        status = napi_get_value_string_utf8(_env, value, _to.data() + offset, length + 1, &length);
+        if (status != napi_ok)
+            throw Napi::Error::New(_env);
+        _to.resize(offset + length);
+    }
+
+    void _encodeBinary(const char *data, size_t length) {
+        _putLength(length, 0, 0, 0xc4, 0xc5, 0xc6);
+        _to.insert(_to.end(), data, data + length);
+    }
+
+    void _encodeDate(double ms) {
+        if (std::isnan(ms))
+            throw Napi::Error::New(_env, "Invalid Date can't be serialized.");
+
+        const int64_t seconds = (int64_t) std::floor(ms / 1000);
+        const uint32_t nanoseconds = (uint32_t) ((ms - seconds * 1000.0) * 1000000);
+
+        if (nanoseconds == 0 && seconds >= 0 && seconds <= 0xffffffff) {
+            _putByte(0xd6);
+            _putByte((uint8_t) EXT_TIMESTAMP);
+            _putBigEndian((uint32_t) seconds);
+        } else if (seconds >= 0 && seconds < (int64_t(1) << 34)) {
+            _putByte(0xd7);
+            _putByte((uint8_t) EXT_TIMESTAMP);
+            _putBigEndian(((uint64_t) nanoseconds << 34) | (uint64_t) seconds);
+        } else {
+            _putByte(0xc7);
+            _putByte(12);
+            _putByte((uint8_t) EXT_TIMESTAMP);
+            _putBigEndian(nanoseconds);
+            _putBigEndian((uint64_t) seconds);
+        };
+    }
+
+    void _encodeArray(const Napi::Array &array, unsigned depth) {
+        const uint32_t length = array.Length();
+        _putLength(length, 0x90, 16, 0, 0xdc, 0xdd);
+        for (uint32_t i = 0; i < length; i++)
+            Encode(array.Get(i), depth + 1);
+    }
+
+    void _encodeObject(const Napi::Object &object, unsigned depth) {
+        const Napi::Array names = object.GetPropertyNames();
+        const uint32_t length = names.Length();
+        _putLength(length, 0x80, 16, 0, 0xde, 0xdf);
+        for (uint32_t i = 0; i < length; i++) {
+            const Napi::Value name = names.Get(i);
+            _encodeString(name);
+            Encode(object.Get(name), depth + 1);
+        };
+    }
+
+    Napi::Env _env;
+    buffer_t &_to;
+};
+
+// Objects of the same layout share their property names, so recently seen map keys
+// are remembered (by their position in the source bytes) to skip UTF-8 decoding.
+struct KeyCacheEntry {
+    const uint8_t *data = NULL;
+    size_t length = 0;
+    napi_value key = NULL;
+};
+
+const size_t KEY_CACHE_SIZE = 64;
+const size_t KEY_CACHE_MAX_KEY_LENGTH = 64;
+
+class Decoder {
+public:
+    Decoder(Napi::Env env, const uint8_t *data, size_t size): _env(env), _pos(data), _end(data + size) {
+
+    }
+
+    Napi::Value Decode(unsigned depth) {
+        if (depth > MAX_DEPTH)
+            _malformed();
+
+        const uint8_t type = _getByte();
+
+        if (type < 0x80)
+            return Napi::Number::New(_env, type);
+        if (type >= 0xe0)
+            return Napi::Number::New(_env, (int8_t) type);
+        if ((type & 0xe0) == 0xa0)
+            return _decodeString(type & 0x1f);
+        if ((type & 0xf0) == 0x90)
+            return _decodeArray(type & 0x0f, depth);
+        if ((type & 0xf0) == 0x80)
+            return _decodeMap(type & 0x0f, depth);
+
+        switch (type) {
+            case 0xc0: return _env.Null();
+            case 0xc2: return Napi::Boolean::New(_env, false);
+            case 0xc3: return Napi::Boolean::New(_env, true);
+
+            case 0xc4: return _decodeBinary(_getBigEndian<uint8_t>());
+            case 0xc5: return _decodeBinary(_getBigEndian<uint16_t>());
+            case 0xc6: return _decodeBinary(_getBigEndian<uint32_t>());
+
+            case 0xc7: return _decodeExt(_getBigEndian<uint8_t>());
+            case 0xc8: return _decodeExt(_getBigEndian<uint16_t>());
+            case 0xc9: return _decodeExt(_getBigEndian<uint32_t>());
+
+            case 0xca: {
+                const uint32_t bits = _getBigEndian<uint32_t>();
+                float number;
+                std::memcpy(&number, &bits, sizeof(number));
+                return Napi::Number::New(_env, number);
+            };
+            case 0xcb: {
+                const uint64_t bits = _getBigEndian<uint64_t>();
+                double number;
+                std::memcpy(&number, &bits, sizeof(number));
+                return Napi::Number::New(_env, number);
+            };
+
+            case 0xcc: return Napi::Number::New(_env, _getBigEndian<uint8_t>());
+            case 0xcd: return Napi::Number::New(_env, _getBigEndian<uint16_t>());
+            case 0xce: return Napi::Number::New(_env, _getBigEndian<uint32_t>());
+            case 0xcf: {
+                const uint64_t number = _getBigEndian<uint64_t>();
+                if (number > (uint64_t) MAX_SAFE_INTEGER)
+                    return Napi::BigInt::New(_env, number);
+                return Napi::Number::New(_env, (double) number);
+            };
+
+            case 0xd0: return Napi::Number::New(_env, (int8_t) _getBigEndian<uint8_t>());
+            case 0xd1: return Napi::Number::New(_env, (int16_t) _getBigEndian<uint16_t>());
+            case 0xd2: return Napi::Number::New(_env, (int32_t) _getBigEndian<uint32_t>());
+            case 0xd3: {
+                const int64_t number = (int64_t) _getBigEndian<uint64_t>();
+                if (number > (int64_t) MAX_SAFE_INTEGER || number < -(int64_t) MAX_SAFE_INTEGER)
+                    return Napi::BigInt::New(_env, number);
+                return Napi::Number::New(_env, (double) number);
+            };
+
+            case 0xd4: return _decodeExt(1);
+            case 0xd5: return _decodeExt(2);
+            case 0xd6: return _decodeExt(4);
+            case 0xd7: return _decodeExt(8);
+            case 0xd8: return _decodeExt(16);
+
+            case 0xd9: return _decodeString(_getBigEndian<uint8_t>());
+            case 0xda: return _decodeString(_getBigEndian<uint16_t>());
+            case 0xdb: return _decodeString(_getBigEndian<uint32_t>());
+
+            case 0xdc: return _decodeArray(_getBigEndian<uint16_t>(), depth);
+            case 0xdd: return _decodeArray(_getBigEndian<uint32_t>(), depth);
+
+            case 0xde: return _decodeMap(_getBigEndian<uint16_t>(), depth);
+            case 0xdf: return _decodeMap(_getBigEndian<uint32_t>(), depth);
+        };
+
+        _malformed();
+        return _env.Undefined();
+    }
+
+    bool AtEnd() const {
+        return _pos == _end;
+    }
+
+private:
+    [[noreturn]] void _malformed() {
+        throw Napi::Error::New(_env, "Malformed msgpack value.");
+    }
+
+    const uint8_t *_take(size_t length) {
+        if ((size_t) (_end - _pos) < length)
+            _malformed();
+        const uint8_t *result = _pos;
+        _pos += length;
+        return result;
+    }
+
+    uint8_t _getByte() {
+        return *_take(1);
+    }
+
+    template<typename T>
+    T _getBigEndian() {
+        return ReadBigEndian<T>(_take(sizeof(T)));
+    }
+
+    Napi::Value _decodeString(size_t length) {
+        const uint8_t *data = _take(length);
+        return Napi::String::New(_env, (const char *) data, length);
+    }
+
+    Napi::Value _decodeBinary(size_t length) {
+        const uint8_t *data = _take(length);
+        return Napi::Buffer<char>::Copy(_env, (const char *) data, length);
+    }
+
+    Napi::Value _decodeExt(size_t length) {
+        const int8_t extType = (int8_t) _getByte();
+        const uint8_t *data = _take(length);
+
+        if (extType == EXT_UNDEFINED && length == 1)
+            return _env.Undefined();
+
+        if (extType == EXT_TIMESTAMP) {
+            int64_t seconds = 0;
+            uint32_t nanoseconds = 0;
+            if (length == 4) {
+                seconds = ReadBigEndian<uint32_t>(data);
+            } else if (length == 8) {
+                const uint64_t packed = ReadBigEndian<uint64_t>(data);
+                nanoseconds = (uint32_t) (packed >> 34);
+                seconds = (int64_t) (packed & ((uint64_t(1) << 34) - 1));
+            } else if (length == 12) {
+                nanoseconds = ReadBigEndian<uint32_t>(data);
+                seconds = (int64_t) ReadBigEndian<uint64_t>(data + 4);
+            } else {
+                _malformed();
+            };
+            return Napi::Date::New(_env, seconds * 1000.0 + nanoseconds / 1000000.0);
+        };
+
+        throw Napi::Error::New(_env, "Unsupported msgpack extension type.");
+    }
+
+    Napi::Value _decodeArray(size_t length, unsigned depth) {
+        // Each element takes at least one byte: protects from huge allocations on malformed input.
+        if (length > (size_t) (_end - _pos))
+            _malformed();
+        Napi::Array array = Napi::Array::New(_env, length);
+        for (size_t i = 0; i < length; i++)
+            array.Set((uint32_t) i, Decode(depth + 1));
+        return array;
+    }
+
+    Napi::Value _decodeMap(size_t length, unsigned depth) {
+        Napi::Object object = Napi::Object::New(_env);
+        for (size_t i = 0; i < length; i++) {
+            napi_value key = _decodeKey(depth);
+            object.Set(key, Decode(depth + 1));
+        };
+        return object;
+    }
+
+    napi_value _decodeKey(unsigned depth) {
+        const uint8_t *start = _pos;
+        const uint8_t type = _getByte();
+
+        size_t length;
+        if ((type & 0xe0) == 0xa0) {
+            length = type & 0x1f;
+        } else if (type == 0xd9) {
+            length = _getBigEndian<uint8_t>();
+        } else {
+            _pos = start;
+            return Decode(depth + 1);
+        };
+
+        const uint8_t *data = _take(length);
+        if (length > KEY_CACHE_MAX_KEY_LENGTH)
+            return Napi::String::New(_env, (const char *) data, length);
+
+        size_t hash = length;
+        for (size_t i = 0; i < length; i++)
+            hash = hash * 31 + data[i];
+        KeyCacheEntry &entry = _keyCache[hash % KEY_CACHE_SIZE];
+
+        if (entry.key != NULL && entry.length == length && std::memcmp(entry.data, data, length) == 0)
+            return entry.key;
+
+        entry.data = data;
+        entry.length = length;
+        entry.key = Napi::String::New(_env, (const char *) data, length);
+        return entry.key;
+    }
+
+    Napi::Env _env;
+    const uint8_t *_pos;
+    const uint8_t *_end;
+    KeyCacheEntry _keyCache[KEY_CACHE_SIZE];
+};
+
+}
+
+void MsgpackEncode(const Napi::Value &from, buffer_t &to) {
+    to.clear();
+    Encoder encoder(from.Env(), to);
+    encoder.Encode(from, 0);
+}
+
+Napi::Value MsgpackDecode(Napi::Env env, const char *data, size_t size) {
+    Decoder decoder(env, (const uint8_t *) data, size);
+    Napi::Value result = decoder.Decode(0);
+    if (!decoder.AtEnd())
+        throw Napi::Error::New(env, "Malformed msgpack value.");
+    return result;
+}
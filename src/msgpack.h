@@ -0,0 +1,10 @@
+#pragma once
+
+#include <napi.h>
+#include "utils.h"
+
+// Serializes JS value to MessagePack. Previous contents of 'to' are discarded.
+void MsgpackEncode(const Napi::Value &from, buffer_t &to);
+
+// Deserializes JS value from MessagePack bytes (e.g. directly from mapped page).
+Napi::Value MsgpackDecode(Napi::Env env, const char *data, size_t size);
@@ -0,0 +1,35 @@
+#include "open_worker.h"
+
+OpenWorker::OpenWorker(Napi::Env env, DbEnvParameters &&parameters):
+    Napi::AsyncWorker(env),
+    _parameters(std::move(parameters)),
+    _deferred(Napi::Promise::Deferred::New(env))
+{
+}
+
+Napi::Promise OpenWorker::GetPromise() {
+    return _deferred.Promise();
+}
+
+void OpenWorker::Execute() {
+    try {
+        DbEnvPtr dbEnvPtr(new DbEnv());
+        dbEnvPtr->Open(_parameters);
+        _dbEnvPtr = dbEnvPtr;
+    } catch(std::exception &e) {
+        SetError(e.what());
+    };
+}
+
+void OpenWorker::OnOK() {
+    Napi::External<DbEnvPtr> opened = Napi::External<DbEnvPtr>::New(
+        Env(),
+        new DbEnvPtr(std::move(_dbEnvPtr)),
+        [](Napi::Env, DbEnvPtr *dbEnvPtr) { delete dbEnvPtr; }
+    );
+    _deferred.Resolve(opened);
+}
+
+void OpenWorker::OnError(const Napi::Error &error) {
+    _deferred.Reject(error.Value());
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <napi.h>
+#include "mdbx.h"
+
+#include "db_env.h"
+
+// Opens the environment (with its declared dbis) on a worker thread, so that recovery of a large
+// datafile doesn't block the event loop. Resolves with an external holding the opened DbEnvPtr,
+// which is then passed to CppMdbx constructor.
+class OpenWorker : public Napi::AsyncWorker {
+public:
+    OpenWorker(Napi::Env env, DbEnvParameters &&parameters);
+
+    Napi::Promise GetPromise();
+
+protected:
+    void Execute() override;
+    void OnOK() override;
+    void OnError(const Napi::Error &error) override;
+
+private:
+    DbEnvParameters _parameters;
+    DbEnvPtr _dbEnvPtr;
+    Napi::Promise::Deferred _deferred;
+};
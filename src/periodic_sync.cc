@@ -0,0 +1,58 @@
+#include "periodic_sync.h"
+
+#include <chrono>
+
+void PeriodicSync::Start(MDBX_env *env, unsigned interval) {
+    Stop();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _env = env;
+    _stopping = false;
+    _stats = PeriodicSyncStats();
+    _stats.interval = interval;
+    _thread = std::thread(&PeriodicSync::_run, this);
+}
+
+void PeriodicSync::Stop() {
+    if (!_thread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    };
+    _wakeUp.notify_all();
+    _thread.join();
+    _env = NULL;
+}
+
+PeriodicSyncStats PeriodicSync::GetStats() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+void PeriodicSync::_run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    const std::chrono::milliseconds interval(_stats.interval);
+
+    while (!_wakeUp.wait_for(lock, interval, [this]() { return _stopping; })) {
+        lock.unlock();
+        const int rc = mdbx_env_sync_ex(_env, true, true);
+        lock.lock();
+
+        if (rc == MDBX_SUCCESS) {
+            _stats.synced++;
+        } else if (rc == MDBX_RESULT_TRUE) {
+            _stats.clean++;
+        } else if (rc == MDBX_BUSY) {
+            _stats.busy++;
+        } else {
+            _stats.errors++;
+            _stats.lastError = rc;
+        };
+    };
+}
+
+PeriodicSync::~PeriodicSync() {
+    Stop();
+}
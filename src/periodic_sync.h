@@ -0,0 +1,40 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "mdbx.h"
+
+struct PeriodicSyncStats {
+    unsigned interval = 0;
+    // Flushes which have written something / found nothing to write.
+    uint64_t synced = 0;
+    uint64_t clean = 0;
+    // Flushes skipped because a write transaction was active.
+    uint64_t busy = 0;
+    uint64_t errors = 0;
+    int lastError = MDBX_SUCCESS;
+};
+
+// Background thread flushing the environment each interval (in milliseconds), so that
+// the data loss after a crash is bounded in lazy sync modes even without further commits.
+// Flush never waits for the write lock: it is skipped while a write transaction is active.
+class PeriodicSync {
+public:
+    void Start(MDBX_env *env, unsigned interval);
+    void Stop();
+    PeriodicSyncStats GetStats();
+
+    ~PeriodicSync();
+
+private:
+    void _run();
+
+    MDBX_env *_env = NULL;
+    std::thread _thread;
+    std::mutex _mutex;
+    std::condition_variable _wakeUp;
+    bool _stopping = false;
+    PeriodicSyncStats _stats;
+};
@@ -0,0 +1,27 @@
+#include "reserved_buffers.h"
+
+Napi::Buffer<char> ReservedBuffers::Create(Napi::Env env, const MDBX_val &value) {
+    if (value.iov_len == 0)
+        return Napi::Buffer<char>::New(env, 0);
+
+    Napi::Buffer<char> buffer = Napi::Buffer<char>::New(env, (char *) value.iov_base, value.iov_len);
+    // Weak reference: collected buffers don't need to be detached.
+    _buffers.push_back(Napi::Reference<Napi::Buffer<char>>::New(buffer, 0));
+    return buffer;
+}
+
+void ReservedBuffers::DetachAll() {
+    if (_buffers.empty())
+        return;
+
+    std::vector<Napi::Reference<Napi::Buffer<char>>> buffers;
+    buffers.swap(_buffers);
+    for (auto &reference : buffers) {
+        Napi::Buffer<char> buffer = reference.Value();
+        if (buffer.IsEmpty())
+            continue;
+        const napi_status status = napi_detach_arraybuffer(buffer.Env(), buffer.ArrayBuffer());
+        if (status != napi_ok)
+            throw Napi::Error::New(buffer.Env());
+    };
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+
+#include <napi.h>
+#include "mdbx.h"
+
+// Buffers pointing into pages reserved with MDBX_RESERVE. Such page space is only valid until the next
+// write or the end of the transaction, so all buffers are detached (become zero-length) at that moment.
+class ReservedBuffers {
+public:
+    Napi::Buffer<char> Create(Napi::Env env, const MDBX_val &value);
+    void DetachAll();
+
+private:
+    std::vector<Napi::Reference<Napi::Buffer<char>>> _buffers;
+};
+
+typedef std::shared_ptr<ReservedBuffers> ReservedBuffersPtr;
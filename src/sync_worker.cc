@@ -0,0 +1,51 @@
+#include "sync_worker.h"
+
+SyncWorker::SyncWorker(Napi::Env env, const DbEnvPtr &dbEnvPtr):
+    Napi::AsyncWorker(env),
+    _dbEnvPtr(dbEnvPtr),
+    _deferred(Napi::Promise::Deferred::New(env))
+{
+    // Worker waits for the write lock, which would never be released by a transaction of this thread.
+    if (_dbEnvPtr->HasTransaction())
+        throw Napi::Error::New(env, "Sync can't be started inside a transaction.");
+    if (_dbEnvPtr->IsBusy())
+        throw Napi::Error::New(env, "Database is busy with a background operation.");
+    if (_dbEnvPtr->IsReadOnly())
+        throw Napi::Error::New(env, "Database is opened in read-only mode.");
+    _env = _dbEnvPtr->GetEnv();
+    _dbEnvPtr->SetBusy(true);
+}
+
+SyncWorker::~SyncWorker() {
+    _release();
+}
+
+Napi::Promise SyncWorker::GetPromise() {
+    return _deferred.Promise();
+}
+
+void SyncWorker::Execute() {
+    const int rc = mdbx_env_sync_ex(_env, true, false);
+    if (rc == MDBX_SUCCESS) {
+        _synced = true;
+    } else if (rc != MDBX_RESULT_TRUE) {
+        SetError(mdbx_strerror(rc));
+    };
+}
+
+void SyncWorker::OnOK() {
+    _release();
+    _deferred.Resolve(Napi::Boolean::New(Env(), _synced));
+}
+
+void SyncWorker::OnError(const Napi::Error &error) {
+    _release();
+    _deferred.Reject(error.Value());
+}
+
+void SyncWorker::_release() {
+    if (_dbEnvPtr) {
+        _dbEnvPtr->SetBusy(false);
+        _dbEnvPtr.reset();
+    };
+}
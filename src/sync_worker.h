@@ -0,0 +1,29 @@
+#pragma once
+
+#include <napi.h>
+#include "mdbx.h"
+
+#include "db_env.h"
+
+// Flushes the environment to disk on a worker thread (mdbx_env_sync_ex with force).
+// Resolves with true if some data has been written, false if there was nothing to flush.
+class SyncWorker : public Napi::AsyncWorker {
+public:
+    SyncWorker(Napi::Env env, const DbEnvPtr &dbEnvPtr);
+    ~SyncWorker();
+
+    Napi::Promise GetPromise();
+
+protected:
+    void Execute() override;
+    void OnOK() override;
+    void OnError(const Napi::Error &error) override;
+
+private:
+    void _release();
+
+    DbEnvPtr _dbEnvPtr;
+    MDBX_env *_env = NULL;
+    Napi::Promise::Deferred _deferred;
+    bool _synced = false;
+};
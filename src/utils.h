@@ -3,6 +3,9 @@
 #include <string>
 #include <vector>
 
+#include <sys/types.h>
+#include <sys/stat.h>
+
 #include <napi.h>
 #include "mdbx.h"
 
@@ -34,6 +37,19 @@ static MDBX_val CreateMdbxVal(const buffer_t &buffer) {
     return val;
 }
 
+// Size of the file or 0 if it doesn't exist.
+static uint64_t GetFileSize(const std::string &path) {
+#ifdef _WIN32
+    struct _stat64 st;
+    if (_stat64(path.c_str(), &st) != 0)
+        return 0;
+#else
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0)
+        return 0;
+#endif
+    return (uint64_t) st.st_size;
+}
 
 // Throwing other than Napi::Error from C++ code to calling JS code leads to program termination
 template<typename F>
@@ -0,0 +1,133 @@
+#include "write_buffer.h"
+#include "db_exception.h"
+
+// Approximate memory overhead of a map node.
+static const size_t ENTRY_OVERHEAD = 64;
+
+static MDBX_val ToMdbxVal(const std::string &from) {
+    MDBX_val result;
+    result.iov_base = (void *) from.data();
+    result.iov_len = from.size();
+    return result;
+}
+
+bool WriteBuffer::KeyLess::operator()(const std::string &a, const std::string &b) const {
+    const MDBX_val aVal = ToMdbxVal(a);
+    const MDBX_val bVal = ToMdbxVal(b);
+    return keyCmp(&aVal, &bVal) < 0;
+}
+
+void WriteBuffer::Reset(size_t limit) {
+    _limit = limit;
+    _bytes = 0;
+    _dbis.clear();
+}
+
+bool WriteBuffer::IsEnabled() {
+    return _limit != 0;
+}
+
+bool WriteBuffer::IsFull() {
+    return _bytes >= _limit;
+}
+
+void WriteBuffer::Put(MDBX_dbi dbi, MDBX_cmp_func *keyCmp, const MDBX_val &key, const MDBX_val *value) {
+    DbiWrites &writes = _dbis.try_emplace(dbi, keyCmp).first->second;
+
+    auto inserted = writes.entries.try_emplace(std::string((const char *) key.iov_base, key.iov_len));
+    Value &entry = inserted.first->second;
+    if (!inserted.second) {
+        const size_t oldBytes = key.iov_len + ENTRY_OVERHEAD + entry.data.size();
+        writes.bytes -= oldBytes;
+        _bytes -= oldBytes;
+    };
+
+    entry.deleted = value == NULL;
+    if (value != NULL)
+        entry.data.assign((const char *) value->iov_base, value->iov_len);
+    else
+        entry.data.clear();
+
+    const size_t newBytes = key.iov_len + ENTRY_OVERHEAD + entry.data.size();
+    writes.bytes += newBytes;
+    _bytes += newBytes;
+}
+
+const WriteBuffer::Value * WriteBuffer::Find(MDBX_dbi dbi, const MDBX_val &key) {
+    auto dbiIt = _dbis.find(dbi);
+    if (dbiIt == _dbis.end())
+        return NULL;
+
+    const Entries &entries = dbiIt->second.entries;
+    auto it = entries.find(std::string((const char *) key.iov_base, key.iov_len));
+    if (it == entries.end())
+        return NULL;
+    return &it->second;
+}
+
+bool WriteBuffer::HasWrites(MDBX_dbi dbi) {
+    return _dbis.find(dbi) != _dbis.end();
+}
+
+void WriteBuffer::Apply(MDBX_txn *txn, MDBX_dbi dbi) {
+    auto it = _dbis.find(dbi);
+    if (it == _dbis.end())
+        return;
+
+    // Writes are removed first, so failed ones are not applied again.
+    Entries entries = std::move(it->second.entries);
+    _bytes -= it->second.bytes;
+    _dbis.erase(it);
+
+    _apply(txn, dbi, entries);
+}
+
+void WriteBuffer::Apply(MDBX_txn *txn) {
+    while (!_dbis.empty())
+        Apply(txn, _dbis.begin()->first);
+}
+
+void WriteBuffer::Discard(MDBX_dbi dbi) {
+    auto it = _dbis.find(dbi);
+    if (it == _dbis.end())
+        return;
+    _bytes -= it->second.bytes;
+    _dbis.erase(it);
+}
+
+void WriteBuffer::Clear() {
+    _bytes = 0;
+    _dbis.clear();
+}
+
+void WriteBuffer::_apply(MDBX_txn *txn, MDBX_dbi dbi, const Entries &entries) {
+    MDBX_cursor *dbCur = NULL;
+
+    int rc = MDBX_SUCCESS;
+    try {
+        rc = mdbx_cursor_open(txn, dbi, &dbCur);
+        CheckMdbxResult(rc);
+
+        for (const auto &entry : entries) {
+            MDBX_val key = ToMdbxVal(entry.first);
+            if (entry.second.deleted) {
+                rc = mdbx_cursor_get(dbCur, &key, NULL, MDBX_SET_KEY);
+                if (rc == MDBX_NOTFOUND)
+                    continue;
+                CheckMdbxResult(rc);
+                rc = mdbx_cursor_del(dbCur, MDBX_CURRENT);
+                CheckMdbxResult(rc);
+            } else {
+                MDBX_val value = ToMdbxVal(entry.second.data);
+                rc = mdbx_cursor_put(dbCur, &key, &value, MDBX_UPSERT);
+                CheckMdbxResult(rc);
+            };
+        };
+
+        mdbx_cursor_close(dbCur);
+    } catch(...) {
+        if (dbCur != NULL)
+            mdbx_cursor_close(dbCur);
+        throw;
+    };
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "mdbx.h"
+
+// Transaction-local buffer of puts and deletes. Writes are kept sorted in the dbi key order
+// and applied through one cursor per dbi, so pages are dirtied sequentially.
+class WriteBuffer {
+public:
+    struct Value {
+        bool deleted = false;
+        std::string data;
+    };
+
+    // Zero limit disables buffering. Buffered writes are discarded.
+    void Reset(size_t limit);
+    bool IsEnabled();
+    bool IsFull();
+
+    // NULL value means deletion.
+    void Put(MDBX_dbi dbi, MDBX_cmp_func *keyCmp, const MDBX_val &key, const MDBX_val *value);
+    // Returns NULL if there are no buffered writes of the key.
+    const Value * Find(MDBX_dbi dbi, const MDBX_val &key);
+    bool HasWrites(MDBX_dbi dbi);
+
+    void Apply(MDBX_txn *txn, MDBX_dbi dbi);
+    void Apply(MDBX_txn *txn);
+    void Discard(MDBX_dbi dbi);
+    void Clear();
+
+private:
+    struct KeyLess {
+        MDBX_cmp_func *keyCmp;
+
+        bool operator()(const std::string &a, const std::string &b) const;
+    };
+
+    typedef std::map<std::string, Value, KeyLess> Entries;
+
+    struct DbiWrites {
+        Entries entries;
+        size_t bytes = 0;
+
+        DbiWrites(MDBX_cmp_func *keyCmp): entries(KeyLess{keyCmp}) {}
+    };
+
+    void _apply(MDBX_txn *txn, MDBX_dbi dbi, const Entries &entries);
+
+    size_t _limit = 0;
+    size_t _bytes = 0;
+    std::map<MDBX_dbi, DbiWrites> _dbis;
+};
@@ -0,0 +1,61 @@
+'use strict';
+const test = require('node:test');
+const assert = require('assert');
+const { MDBX, withDb } = require('./helpers');
+
+test('analyze of the opened database reports its dbis', async () => {
+    await withDb('analyze', { valueMode: 'string' }, async db => {
+        db.transact(txn => {
+            const dbi = txn.getDbi('items');
+            for (let i = 0; i < 1000; i++)
+                dbi.put(`key${String(i).padStart(4, '0')}`, 'v'.repeat(100));
+            const names = txn.getDbi('names', { comparator: 'lengthFirst' });
+            for (const key of ['bb', 'a', 'ccc'])
+                names.put(key, key);
+        });
+        const result = await db.analyze();
+        assert.strictEqual(result.dbis.items.entries, 1000);
+        assert.strictEqual(result.dbis.items.sampled, 1000);
+        assert.strictEqual(result.dbis.items.keySizes.max, 7);
+        assert.strictEqual(result.dbis.items.valueSizes.max, 100);
+        assert.strictEqual(result.dbis.names.entries, 3);
+        assert.strictEqual(result.dbis.__node_mdbx_key_comparators, undefined);
+        assert.ok(result.pages.leaf > 0);
+        assert.ok(result.recommendation.pageSize >= 1024);
+        // Database remains usable, dbis keep their comparators.
+        db.transact(txn => {
+            const names = txn.getDbi('names', { comparator: 'lengthFirst' });
+            assert.strictEqual(names.first(), 'a');
+            txn.getDbi('items').put('after', 'analyze');
+        });
+    });
+});
+
+test('analyze binds not yet opened dbis with their recorded comparators', async () => {
+    await withDb('analyze_reopen', { valueMode: 'string' }, async (db, dbPath) => {
+        db.transact(txn => {
+            const names = txn.getDbi('names', { comparator: 'lengthFirst' });
+            for (const key of ['bb', 'a', 'ccc'])
+                names.put(key, key);
+        });
+        db.close();
+        const reopened = new MDBX({ path: dbPath, maxDbs: 8, valueMode: 'string' });
+        try {
+            const result = await reopened.analyze();
+            assert.strictEqual(result.dbis.names.entries, 3);
+            reopened.transact(txn => {
+                const names = txn.getDbi('names', { comparator: 'lengthFirst' });
+                assert.deepStrictEqual([names.first(), names.next('a'), names.next('bb')], ['a', 'bb', 'ccc']);
+            });
+        } finally {
+            reopened.close();
+        };
+    });
+});
+
+test('analyze of the closed database throws', async () => {
+    await withDb('analyze_closed', {}, async db => {
+        db.close();
+        await assert.rejects(() => db.analyze());
+    });
+});
\ No newline at end of file
@@ -0,0 +1,27 @@
+'use strict';
+const test = require('node:test');
+const assert = require('assert');
+const NodeMdbx = require('../lib/binding.js');
+const { tempDbPath, removeDbPath } = require('./helpers');
+
+test('module exports MDBX class', () => {
+    assert(NodeMdbx, 'The expected module is undefined');
+    assert.strictEqual(NodeMdbx.MDBX, NodeMdbx);
+});
+
+test('basic instance', () => {
+    const dbPath = tempDbPath('binding');
+    try {
+        const instance = new NodeMdbx({ path: dbPath });
+        assert.strictEqual(instance.closed, false);
+        instance.close();
+        assert.strictEqual(instance.closed, true);
+    } finally {
+        removeDbPath(dbPath);
+    };
+});
+
+test('invalid params', () => {
+    assert.throws(() => new NodeMdbx());
+    assert.throws(() => new NodeMdbx({}), /DB path is not a string/);
+});
\ No newline at end of file
@@ -0,0 +1,99 @@
+'use strict';
+const test = require('node:test');
+const assert = require('assert');
+const { Readable } = require('stream');
+const fs = require('fs');
+const path = require('path');
+const { withDb } = require('./helpers');
+
+function lines(records) {
+    return Readable.from([Buffer.from(records.map(([key, value]) => `${key}\t${value}\n`).join(''))]);
+}
+
+function lengthPrefixed(records) {
+    return Buffer.concat(records.flatMap(([key, value]) => [key, value].flatMap(item => {
+        const length = Buffer.alloc(4);
+        length.writeUInt32LE(Buffer.byteLength(item));
+        return [length, Buffer.from(item)];
+    })));
+}
+
+function keyOf(i) {
+    return `key${String(i).padStart(5, '0')}`;
+}
+
+function entries(dbi) {
+    const result = [];
+    for (let key = dbi.first(); key !== undefined; key = dbi.next(key))
+        result.push([key, dbi.get(key)]);
+    return result;
+}
+
+test('bulkLoad stores values as is for string valueMode and rejects msgpack one', async () => {
+    await withDb('bulk_load', {}, async db => {
+        await db.bulkLoad('strings', lines([['a', 'first'], ['b', 'second']]), {
+            format: 'lines', dbiOptions: { valueMode: 'string' },
+        });
+        db.transact(txn => assert.strictEqual(txn.getDbi('strings').get('b'), 'second'));
+
+        await assert.rejects(db.bulkLoad('objects', lines([['a', 'first']]), {
+            format: 'lines', dbiOptions: { valueMode: 'msgpack' },
+        }), /not supported for dbis with msgpack valueMode/);
+        db.transact(txn => assert.strictEqual(txn.getDbi('objects').has('a'), false));
+    });
+});
+
+test('bulkLoad splits sorted input into transactions and reports the result', async () => {
+    const records = Array.from({ length: 1000 }, (_, i) => [keyOf(i), `value ${i}`]);
+    await withDb('bulk_load', {}, async db => {
+        const progress = [];
+        const result = await db.bulkLoad('items', Readable.from([lengthPrefixed(records)]), {
+            sorted: true, txnBytes: 4096, dbiOptions: { valueMode: 'string' },
+            onProgress: total => progress.push(total),
+        });
+        const bytes = records.reduce((sum, [key, value]) => sum + key.length + value.length, 0);
+        assert.deepStrictEqual(result, { records: 1000, skipped: 0, bytes, lastKey: keyOf(999) });
+        assert.ok(progress.length > 1);
+        assert.deepStrictEqual(progress[progress.length - 1], result);
+        db.transact(txn => assert.deepStrictEqual(entries(txn.getDbi('items')), records));
+    });
+});
+
+test('bulkLoad resumes sorted input from a file descriptor', async () => {
+    const records = Array.from({ length: 100 }, (_, i) => [keyOf(i), `value ${i}`]);
+    await withDb('bulk_load', { valueMode: 'string' }, async (db, dbPath) => {
+        db.transact(txn => {
+            const dbi = txn.getDbi('items');
+            for (const [key, value] of records.slice(0, 40))
+                dbi.put(key, value);
+        });
+        const inputPath = path.join(dbPath, 'input.txt');
+        fs.writeFileSync(inputPath, records.map(([key, value]) => `${key}\t${value}\n`).join(''));
+        const fd = fs.openSync(inputPath, 'r');
+        try {
+            const result = await db.bulkLoad('items', fd, { format: 'lines', sorted: true, resume: true });
+            assert.strictEqual(result.records, 60);
+            assert.strictEqual(result.skipped, 40);
+            assert.strictEqual(result.lastKey, keyOf(99));
+        } finally {
+            fs.closeSync(fd);
+        };
+        db.transact(txn => assert.deepStrictEqual(entries(txn.getDbi('items')), records));
+    });
+});
+
+test('bulkLoad rejects malformed and unsorted input', async () => {
+    await withDb('bulk_load', { valueMode: 'string' }, async db => {
+        await assert.rejects(db.bulkLoad('items', Readable.from([Buffer.from('no tab\n')]), { format: 'lines' }),
+            /Malformed record: no tab between key and value/);
+        await assert.rejects(db.bulkLoad('items', Readable.from([lengthPrefixed([['a', 'b']]).subarray(0, 7)])),
+            /Truncated record/);
+        await assert.rejects(db.bulkLoad('items', lines([['b', '1'], ['a', '2']]), { format: 'lines', sorted: true }));
+        await assert.rejects(db.bulkLoad('items', lines([]), { format: 'lines', resume: true }),
+            /Resume is only possible for sorted input/);
+        await assert.rejects(db.bulkLoad('items', {}), /Source should be a file descriptor or an async iterable/);
+        // Database remains usable after failed loads.
+        db.transact(txn => txn.getDbi('items').put('c', '3'));
+        db.transact(txn => assert.strictEqual(txn.getDbi('items').get('c'), '3'));
+    });
+});
\ No newline at end of file
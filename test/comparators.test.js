@@ -0,0 +1,108 @@
+'use strict';
+const test = require('node:test');
+const assert = require('assert');
+const { MDBX, tempDbPath, removeDbPath, withDb } = require('./helpers');
+
+const KEYS = ['bb', 'a', 'ccc', 'B'];
+
+// Runs actions one by one, each with a fresh instance of the same database.
+function reopen(actions) {
+    const dbPath = tempDbPath('comparators');
+    try {
+        for (const action of actions) {
+            const db = new MDBX({ path: dbPath, maxDbs: 2 });
+            try {
+                action(db, dbPath);
+            } finally {
+                db.close();
+            };
+        };
+    } finally {
+        removeDbPath(dbPath);
+    };
+}
+
+function keys(dbi) {
+    const result = [];
+    for (let key = dbi.first(); key !== undefined; key = dbi.next(key))
+        result.push(key);
+    return result;
+}
+
+test('mismatched comparator does not bind the dbi', () => {
+    reopen([
+        db => db.transact(txn => {
+            const dbi = txn.getDbi('names', { comparator: 'lengthFirst' });
+            for (const key of KEYS)
+                dbi.put(key, key);
+        }),
+        db => db.transact(txn => {
+            assert.throws(() => txn.getDbi('names', { comparator: 'asciiCaseInsensitive' }),
+                /has been created with 'lengthFirst' key comparator/);
+            assert.throws(() => txn.getDbi('names'), /has been created with 'lengthFirst' key comparator/);
+            assert.deepStrictEqual(keys(txn.getDbi('names', { comparator: 'lengthFirst' })), ['B', 'a', 'bb', 'ccc']);
+        }),
+    ]);
+});
+
+test('comparator can not be set for existing dbi', () => {
+    reopen([
+        db => db.transact(txn => {
+            const dbi = txn.getDbi('names');
+            for (const key of KEYS)
+                dbi.put(key, key);
+        }),
+        db => db.transact(txn => {
+            assert.throws(() => txn.getDbi('names', { comparator: 'lengthFirst' }),
+                /has been created with default key order/);
+            assert.deepStrictEqual(keys(txn.getDbi('names')), ['B', 'a', 'bb', 'ccc']);
+        }),
+    ]);
+});
+
+test('service dbi does not take a slot of maxDbs and is not analyzed', async () => {
+    const dbPath = tempDbPath('comparators');
+    try {
+        const db = new MDBX({ path: dbPath, maxDbs: 2 });
+        db.transact(txn => {
+            txn.getDbi('first', { comparator: 'asciiCaseInsensitive' }).put('key', 'value');
+            txn.getDbi('second', { comparator: 'lengthFirst' }).put('key', 'value');
+        });
+        db.close();
+
+        const analysis = await MDBX.analyze(dbPath);
+        assert.deepStrictEqual(Object.keys(analysis.dbis).sort(), ['', 'first', 'second']);
+        // Records of the main dbi are named dbis (including the service one), none are counted as data.
+        assert.strictEqual(analysis.dbis[''].entries, 0);
+        assert.strictEqual(analysis.dbis[''].sampled, 0);
+    } finally {
+        removeDbPath(dbPath);
+    };
+});
+
+test('service dbi record is hidden from the main dbi', async () => {
+    await withDb('comparators', { maxDbs: 1, valueMode: 'string' }, db => db.transact(txn => {
+        txn.getDbi('names', { comparator: 'lengthFirst' }).put('key', 'value');
+        const main = txn.getDbi(null);
+        // '_' sorts after uppercase letters and before lowercase ones, so the service record is between these keys.
+        main.put('Z', 'before');
+        main.put('a', 'after');
+        assert.deepStrictEqual(keys(main), ['Z', 'a', 'names']);
+        assert.strictEqual(main.next('Z'), 'a');
+        assert.strictEqual(main.prev('a'), 'Z');
+        assert.strictEqual(main.lowerBound('_'), 'a');
+        assert.strictEqual(main.get('__node_mdbx_key_comparators'), undefined);
+        assert.strictEqual(main.has('__node_mdbx_key_comparators'), false);
+    }));
+});
+
+test('named dbis are limited by maxDbs', async () => {
+    await withDb('comparators', { maxDbs: 1 }, db => db.transact(txn => {
+        txn.getDbi('first', { comparator: 'lengthFirst' });
+        assert.throws(() => txn.getDbi('second'), /MDBX_DBS_FULL|maxdbs/i);
+    }));
+    await withDb('comparators', { maxDbs: 0 }, db => db.transact(txn => {
+        txn.getDbi(null);
+        assert.throws(() => txn.getDbi('first'), /MDBX_DBS_FULL|maxdbs/i);
+    }));
+});
\ No newline at end of file
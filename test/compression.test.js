@@ -0,0 +1,202 @@
+'use strict';
+const test = require('node:test');
+const assert = require('assert');
+const crypto = require('crypto');
+const { MDBX, tempDbPath, removeDbPath } = require('./helpers');
+
+const LZ4 = { compression: 'lz4', compressionThreshold: 0 };
+const MALFORMED = /Malformed compressed value/;
+
+// Creates dbi with 'readOptions', writes values through a dbi opened with 'writeOptions' and reads them back
+// through a fresh instance with 'readOptions' (options of the dbi can't be changed while the database is opened).
+function rewrite(entries, writeOptions, readOptions, read) {
+    const dbPath = tempDbPath('compression');
+    try {
+        let db = new MDBX({ path: dbPath, maxDbs: 4 });
+        db.transact(txn => txn.getDbi('values', readOptions));
+        db.close();
+
+        db = new MDBX({ path: dbPath, maxDbs: 4 });
+        db.transact(txn => {
+            const dbi = txn.getDbi('values', writeOptions);
+            for (const [key, value] of entries)
+                dbi.put(key, value);
+        });
+        db.close();
+
+        db = new MDBX({ path: dbPath, maxDbs: 4 });
+        try {
+            return db.transact(txn => read(txn.getDbi('values', readOptions)));
+        } finally {
+            db.close();
+        };
+    } finally {
+        removeDbPath(dbPath);
+    };
+}
+
+// Raw stored frames of the values compressed by the codec.
+function compressedFrames(entries) {
+    return rewrite(entries, LZ4, { compression: 'none' }, dbi => entries.map(([key]) => dbi.get(key)));
+}
+
+function lz4Frame(size, block) {
+    const header = Buffer.alloc(6);
+    header[0] = 0xc1;
+    header[1] = 1;
+    header.writeUInt32LE(size, 2);
+    return Buffer.concat([header, Buffer.from(block)]);
+}
+
+function randomBuffer(size) {
+    return crypto.randomBytes(size);
+}
+
+test('lz4 round trip', () => {
+    const block = randomBuffer(70000);
+    const samples = {
+        empty: Buffer.alloc(0),
+        small: Buffer.from('abc'),
+        incompressible: randomBuffer(100000),
+        repetitive: Buffer.alloc(1 << 20, 'a'),
+        pattern: Buffer.from('0123456789abcdef'.repeat(10000)),
+        // Repeated block is farther than the maximum match offset (65535 bytes).
+        farRepeat: Buffer.concat([block, randomBuffer(1000), block]),
+        nearRepeat: Buffer.concat([randomBuffer(30000), randomBuffer(5000)]).fill(7, 10000, 20000),
+        marker: Buffer.concat([Buffer.from([0xc1, 0x00]), randomBuffer(300)]),
+    };
+    const entries = Object.entries(samples);
+
+    const result = rewrite(entries, LZ4, LZ4, dbi => entries.map(([key]) => dbi.get(key)));
+    entries.forEach(([key, value], i) => assert.ok(value.equals(result[i]), key));
+
+    const frames = compressedFrames(entries);
+    assert.ok(frames[entries.findIndex(([key]) => key == 'repetitive')].length < 10000);
+    // Incompressible value is stored as is.
+    assert.ok(frames[entries.findIndex(([key]) => key == 'incompressible')].equals(samples.incompressible));
+});
+
+test('lz4 crafted frames', () => {
+    const frames = {
+        empty: lz4Frame(0, [0x00]),
+        literals: lz4Frame(5, [0x50, 1, 2, 3, 4, 5]),
+        // Overlapping match: 1 literal repeated by a match of 4 + 5 bytes at offset 1.
+        overlap: lz4Frame(11, [0x15, 9, 1, 0, 0x10, 8]),
+    };
+    const expected = {
+        empty: Buffer.alloc(0),
+        literals: Buffer.from([1, 2, 3, 4, 5]),
+        overlap: Buffer.from([9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 8]),
+    };
+    const entries = Object.entries(frames);
+    const result = rewrite(entries, {}, LZ4, dbi => entries.map(([key]) => dbi.get(key)));
+    entries.forEach(([key], i) => assert.ok(expected[key].equals(result[i]), key));
+});
+
+test('lz4 malformed frames throw', () => {
+    const frames = {
+        noBlock: lz4Frame(0, []),
+        noHeader: Buffer.from([0xc1]),
+        shortHeader: Buffer.from([0xc1, 1, 5, 0]),
+        unknownMethod: Buffer.from([0xc1, 7, 1, 2, 3]),
+        literalsPastInput: lz4Frame(5, [0x50, 1, 2]),
+        literalsPastOutput: lz4Frame(2, [0x50, 1, 2, 3, 4, 5]),
+        longLiteralsTruncated: lz4Frame(300, [0xf0, 255]),
+        zeroOffset: lz4Frame(10, [0x11, 1, 0, 0]),
+        offsetBeforeStart: lz4Frame(10, [0x11, 1, 2, 0]),
+        truncatedOffset: lz4Frame(10, [0x11, 1, 1]),
+        matchPastOutput: lz4Frame(6, [0x1f, 1, 1, 0, 200]),
+        shortOutput: lz4Frame(10, [0x50, 1, 2, 3, 4, 5]),
+    };
+    const entries = Object.entries(frames);
+    const result = rewrite(entries, {}, LZ4, dbi => entries.map(([key]) => {
+        try {
+            return dbi.get(key);
+        } catch (error) {
+            return error;
+        };
+    }));
+    entries.forEach(([key], i) => {
+        assert.ok(result[i] instanceof Error, key);
+        assert.match(result[i].message, MALFORMED, key);
+    });
+});
+
+test('lz4 truncated and corrupted frames', () => {
+    const source = Buffer.from(Array.from({ length: 2000 }, (_, i) => `item ${i % 97};`).join(''));
+    const [frame] = compressedFrames([['source', source]]);
+    assert.equal(frame[0], 0xc1);
+
+    const entries = [];
+    // Every truncation misses either some data or the declared size.
+    for (let length = 1; length < frame.length; length++)
+        entries.push([`truncated ${length}`, frame.subarray(0, length)]);
+    for (let i = 0; i < 200; i++) {
+        const corrupted = Buffer.from(frame);
+        const position = 2 + crypto.randomInt(corrupted.length - 2);
+        corrupted[position] ^= 1 + crypto.randomInt(255);
+        entries.push([`corrupted ${i}`, corrupted]);
+    };
+
+    const result = rewrite(entries, {}, LZ4, dbi => entries.map(([key]) => {
+        try {
+            return dbi.get(key);
+        } catch (error) {
+            return error;
+        };
+    }));
+    entries.forEach(([key], i) => {
+        if (key.startsWith('truncated')) {
+            assert.ok(result[i] instanceof Error, key);
+            assert.match(result[i].message, MALFORMED, key);
+        } else if (!(result[i] instanceof Error)) {
+            // Corrupted literals decode into other data, but never beyond the declared size.
+            assert.equal(result[i].length, entries[i][1].readUInt32LE(2), key);
+        } else {
+            assert.match(result[i].message, MALFORMED, key);
+        };
+    });
+});
+
+test('compression is not enabled for non-empty buffer dbi', () => {
+    const dbPath = tempDbPath('compression');
+    try {
+        let db = new MDBX({ path: dbPath, maxDbs: 4 });
+        db.transact(txn => txn.getDbi('values').put('raw', Buffer.from([0xc1, 1, 2, 3])));
+        db.close();
+
+        db = new MDBX({ path: dbPath, maxDbs: 4 });
+        try {
+            assert.throws(() => db.transact(txn => txn.getDbi('values', LZ4)), /Compression can't be enabled/);
+            // String values never start with the marker.
+            db.transact(txn => txn.getDbi('strings', { valueMode: 'string' }).put('a', 'b'));
+        } finally {
+            db.close();
+        };
+
+        db = new MDBX({ path: dbPath, maxDbs: 4 });
+        try {
+            db.transact(txn => {
+                assert.ok(txn.getDbi('values').get('raw').equals(Buffer.from([0xc1, 1, 2, 3])));
+                assert.strictEqual(txn.getDbi('strings', { valueMode: 'string', ...LZ4 }).get('a'), 'b');
+                // Dropped dbi could be created again with compression.
+                txn.clearDbi('values', true);
+            });
+            db.transact(txn => txn.getDbi('values', LZ4).put('raw', Buffer.from([0xc1, 1, 2, 3])));
+        } finally {
+            db.close();
+        };
+
+        // Dbi created with compression stays compressed after reopening.
+        db = new MDBX({ path: dbPath, maxDbs: 4 });
+        try {
+            db.transact(txn => {
+                assert.ok(txn.getDbi('values', LZ4).get('raw').equals(Buffer.from([0xc1, 1, 2, 3])));
+            });
+        } finally {
+            db.close();
+        };
+    } finally {
+        removeDbPath(dbPath);
+    };
+});
\ No newline at end of file
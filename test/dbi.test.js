@@ -0,0 +1,95 @@
+'use strict';
+const test = require('node:test');
+const assert = require('assert');
+const { withDb } = require('./helpers');
+
+const WRONG_DELTA = /Wrong delta; should be an integer/;
+
+test('increment rejects deltas which are not int64 integers', async () => {
+    await withDb('dbi', {}, db => db.transact(txn => {
+        const dbi = txn.getDbi('counters');
+        for (const delta of [NaN, Infinity, -Infinity, 0.5, 2 ** 63, -(2 ** 64), 1e300])
+            assert.throws(() => dbi.increment('key', delta), WRONG_DELTA, String(delta));
+        assert.strictEqual(dbi.has('key'), false);
+        assert.strictEqual(dbi.increment('key', -(2 ** 53 - 1)), -(2 ** 53 - 1));
+    }));
+});
+
+test('increment keeps number results within safe integers', async () => {
+    await withDb('dbi', {}, db => db.transact(txn => {
+        const dbi = txn.getDbi('counters');
+        assert.strictEqual(dbi.increment('key', 2 ** 53 - 2), 2 ** 53 - 2);
+        assert.strictEqual(dbi.increment('key'), 2 ** 53 - 1);
+        assert.throws(() => dbi.increment('key'), /out of safe integer range/);
+        assert.strictEqual(dbi.increment('key', 0n), 2n ** 53n - 1n);
+        assert.strictEqual(dbi.increment('key', 2n ** 60n), 2n ** 60n + 2n ** 53n - 1n);
+    }));
+});
+
+test('compareAndSwap expects absence only outside msgpack valueMode', async () => {
+    await withDb('dbi', { valueMode: 'string' }, db => db.transact(txn => {
+        const strings = txn.getDbi('strings');
+        assert.strictEqual(strings.compareAndSwap('key', undefined, 'first'), true);
+        assert.strictEqual(strings.compareAndSwap('key', undefined, 'second'), false);
+        assert.strictEqual(strings.compareAndSwap('key', 'first', 'second'), true);
+        assert.strictEqual(strings.get('key'), 'second');
+
+        const objects = txn.getDbi('objects', { valueMode: 'msgpack' });
+        objects.put('key', undefined);
+        assert.throws(() => objects.compareAndSwap('key', undefined, 1), /undefined is ambiguous in msgpack valueMode/);
+        assert.throws(() => objects.compareAndSwap('absent', undefined, 1), /undefined is ambiguous in msgpack valueMode/);
+        assert.strictEqual(objects.compareAndSwap('key', null, 1), false);
+        assert.strictEqual(objects.putIfAbsent('absent', { a: 1 }), true);
+        assert.strictEqual(objects.compareAndSwap('absent', { a: 1 }, { a: 2 }), true);
+        assert.deepStrictEqual(objects.get('absent'), { a: 2 });
+    }));
+});
+
+function idKey(id) {
+    const key = Buffer.alloc(8);
+    key.writeBigUInt64BE(BigInt(id));
+    return key;
+}
+
+test('putAutoId appends big-endian ids', async () => {
+    await withDb('dbi', { keyMode: 'buffer', valueMode: 'string' }, db => db.transact(txn => {
+        const dbi = txn.getDbi('records');
+        assert.strictEqual(dbi.putAutoId('first'), 1);
+        assert.strictEqual(dbi.putAutoId('second'), 2);
+        assert.strictEqual(dbi.get(idKey(2)), 'second');
+        assert.deepStrictEqual(dbi.last(), idKey(2));
+    }));
+});
+
+test('putAutoId rejects dbis whose keys can not be appended', async () => {
+    await withDb('dbi', {}, db => db.transact(txn => {
+        assert.throws(() => txn.getDbi('records').putAutoId('value'), /not supported in 'string' keyMode/);
+    }));
+    await withDb('dbi', { keyMode: 'buffer' }, db => db.transact(txn => {
+        assert.throws(() => txn.getDbi('reversed', { reverseKey: true }).putAutoId('value'),
+            /not supported for dbis with reverseKey or custom key order/);
+        for (const comparator of ['lengthFirst', 'asciiCaseInsensitive'])
+            assert.throws(() => txn.getDbi(comparator, { comparator }).putAutoId('value'),
+                /not supported for dbis with reverseKey or custom key order/);
+
+        const dbi = txn.getDbi('records');
+        dbi.put(idKey(10), 'manual');
+        assert.throws(() => dbi.putAutoId('value'), /Dbi contains keys greater than the allocated id/);
+        dbi.sequence(10);
+        assert.strictEqual(dbi.putAutoId('value'), 12);
+    }));
+});
+
+test('sequence keeps precision', async () => {
+    await withDb('dbi', { keyMode: 'buffer' }, db => db.transact(txn => {
+        const dbi = txn.getDbi('records');
+        assert.strictEqual(dbi.sequence(Number.MAX_SAFE_INTEGER - 1), 0);
+        assert.strictEqual(dbi.sequence(1), Number.MAX_SAFE_INTEGER - 1);
+        assert.throws(() => dbi.sequence(1), /out of safe integer range/);
+        assert.throws(() => dbi.putAutoId('value'), /out of safe integer range/);
+        assert.strictEqual(dbi.sequence(), Number.MAX_SAFE_INTEGER);
+        assert.strictEqual(dbi.sequence(2n), BigInt(Number.MAX_SAFE_INTEGER));
+        assert.throws(() => dbi.sequence(), /out of safe integer range/);
+        assert.strictEqual(dbi.sequence(0n), BigInt(Number.MAX_SAFE_INTEGER) + 2n);
+    }));
+});
\ No newline at end of file
@@ -0,0 +1,49 @@
+'use strict';
+const test = require('node:test');
+const assert = require('assert');
+const { withDb } = require('./helpers');
+
+test('getDbi returns cached dbi for the same options', async () => {
+    await withDb('dbi_cache', {}, db => {
+        const first = db.transact(txn => txn.getDbi('items', { valueMode: 'string' }));
+        db.transact(txn => {
+            assert.strictEqual(txn.getDbi('items'), first);
+            assert.strictEqual(txn.getDbi('items', { valueMode: 'string' }), first);
+            assert.throws(() => txn.getDbi('items', { valueMode: 'msgpack' }), /different parameters/);
+            assert.strictEqual(txn.getDbi('items', { valueMode: 'string' }), first);
+        });
+    });
+});
+
+test('dropped dbi handle becomes stale and is reopened', async () => {
+    await withDb('dbi_cache_drop', { valueMode: 'string' }, db => {
+        const dropped = db.transact(txn => {
+            const dbi = txn.getDbi('items');
+            dbi.put('a', '1');
+            return dbi;
+        });
+        db.transact(txn => txn.clearDbi('items', true));
+        db.transact(txn => {
+            assert.strictEqual(dropped.isStale(), true);
+            const dbi = txn.getDbi('items', { valueMode: 'string' });
+            assert.notStrictEqual(dbi, dropped);
+            assert.strictEqual(dbi.isStale(), false);
+            assert.strictEqual(dbi.get('a'), undefined);
+        });
+    });
+});
+
+test('dbi opened by an aborted transaction is reopened', async () => {
+    await withDb('dbi_cache_abort', { valueMode: 'string' }, db => {
+        let aborted;
+        assert.throws(() => db.transact(txn => {
+            aborted = txn.getDbi('items');
+            throw new Error('abort');
+        }), /abort/);
+        db.transact(txn => {
+            const dbi = txn.getDbi('items');
+            assert.notStrictEqual(dbi, aborted);
+            dbi.put('a', '1');
+        });
+    });
+});
\ No newline at end of file
@@ -0,0 +1,93 @@
+'use strict';
+const test = require('node:test');
+const assert = require('assert');
+const { withDb } = require('./helpers');
+
+function keyOf(i) {
+    return `k${String(i).padStart(5, '0')}`;
+}
+
+function fill(db, count) {
+    db.transact(txn => {
+        const dbi = txn.getDbi('items');
+        for (let i = 0; i < count; i++)
+            dbi.put(keyOf(i), 'v'.repeat(50));
+    });
+}
+
+function keys(dbi) {
+    const result = [];
+    for (let key = dbi.first(); key !== undefined; key = dbi.next(key))
+        result.push(key);
+    return result;
+}
+
+test('delRange deletes keys from gte inclusive to lt exclusive', async () => {
+    await withDb('del_range', { valueMode: 'string' }, db => {
+        fill(db, 10);
+        db.transact(txn => {
+            const dbi = txn.getDbi('items');
+            assert.strictEqual(dbi.delRange({ gte: keyOf(2), lt: keyOf(4) }), 2);
+            assert.strictEqual(dbi.delRange({ gte: keyOf(2), lt: keyOf(4) }), 0);
+            assert.strictEqual(dbi.delRange({ lt: keyOf(1) }), 1);
+            // Range up to the end of the dbi.
+            assert.strictEqual(dbi.delRange({ gte: keyOf(8) }), 2);
+            assert.strictEqual(dbi.delRange({ gte: keyOf(5), limit: 2 }), 2);
+            assert.strictEqual(dbi.delRange({ gte: keyOf(9) }), 0);
+            assert.deepStrictEqual(keys(dbi), [keyOf(1), keyOf(4), keyOf(7)]);
+        });
+    });
+});
+
+test('delRange of the whole dbi drops its pages at once', async () => {
+    await withDb('del_range', { valueMode: 'string' }, db => {
+        fill(db, 5000);
+        db.transact(txn => {
+            const dbi = txn.getDbi('items');
+            assert.strictEqual(dbi.delRange({ gte: keyOf(1) }), 4999);
+            // Cursor walk dirties the pages.
+            assert.ok(txn.dirtyBytes() > 0);
+        });
+        fill(db, 5000);
+        db.transact(txn => {
+            const dbi = txn.getDbi('items');
+            // Bounds outside of the keys still cover the whole dbi.
+            assert.strictEqual(dbi.delRange({ gte: 'a', lt: 'z' }), 5000);
+            assert.strictEqual(txn.dirtyBytes(), 0);
+            assert.strictEqual(dbi.first(), undefined);
+            dbi.put('after', 'drop');
+        });
+        db.transact(txn => assert.deepStrictEqual(keys(txn.getDbi('items')), ['after']));
+    });
+});
+
+test('delRange limit below the dbi size walks the keys', async () => {
+    await withDb('del_range', { valueMode: 'string' }, db => {
+        fill(db, 100);
+        db.transact(txn => {
+            const dbi = txn.getDbi('items');
+            assert.strictEqual(dbi.delRange({ limit: 99 }), 99);
+            assert.deepStrictEqual(keys(dbi), [keyOf(99)]);
+            assert.strictEqual(dbi.delRange({ limit: 0 }), 0);
+            assert.deepStrictEqual(keys(dbi), [keyOf(99)]);
+        });
+    });
+});
+
+test('delRange applies buffered writes and splits transactions', async () => {
+    await withDb('del_range', { valueMode: 'string' }, db => {
+        db.transact(txn => {
+            const dbi = txn.getDbi('items');
+            for (let i = 0; i < 10; i++)
+                dbi.put(keyOf(i), 'value');
+            assert.strictEqual(dbi.delRange({ gte: keyOf(5) }), 5);
+            assert.strictEqual(dbi.get(keyOf(5)), undefined);
+            assert.strictEqual(dbi.get(keyOf(4)), 'value');
+        }, { writeBufferBytes: 1024 * 1024 });
+        fill(db, 20000);
+        db.transact(txn => {
+            assert.strictEqual(txn.getDbi('items').delRange({ gte: keyOf(1) }), 19999);
+        }, { autoSplitBytes: 64 * 1024 });
+        db.transact(txn => assert.deepStrictEqual(keys(txn.getDbi('items')), [keyOf(0)]));
+    });
+});
\ No newline at end of file
@@ -0,0 +1,48 @@
+'use strict';
+const test = require('node:test');
+const assert = require('assert');
+const { withDb } = require('./helpers');
+
+const MB = 1024 * 1024;
+const GEOMETRY = { sizeLower: MB, sizeNow: MB, sizeUpper: 64 * MB, growthStep: MB, shrinkThreshold: 2 * MB };
+
+test('geometry options are applied and growth is counted', async () => {
+    await withDb('geometry', GEOMETRY, db => {
+        const before = db.stats().geometry;
+        assert.strictEqual(before.sizeLower, MB);
+        assert.strictEqual(before.sizeNow, MB);
+        assert.strictEqual(before.sizeUpper, 64 * MB);
+        assert.strictEqual(before.growthStep, MB);
+        assert.strictEqual(before.shrinkThreshold, 2 * MB);
+        assert.strictEqual(before.grows, 0);
+
+        const value = Buffer.alloc(1000, 1);
+        for (let batch = 0; batch < 4; batch++) {
+            db.transact(txn => {
+                const dbi = txn.getDbi('items');
+                for (let i = 0; i < 1000; i++)
+                    dbi.put(`key${batch}_${i}`, value);
+            });
+        };
+        const after = db.stats().geometry;
+        assert.ok(after.sizeNow >= 4 * MB);
+        assert.ok(after.grows > 0);
+        assert.strictEqual(after.sizeNow % MB, 0);
+    });
+});
+
+test('setGeometry changes geometry of the opened database', async () => {
+    await withDb('geometry', GEOMETRY, db => {
+        db.setGeometry({ sizeUpper: 128 * MB, growthStep: 2 * MB });
+        const geometry = db.stats().geometry;
+        assert.strictEqual(geometry.sizeUpper, 128 * MB);
+        assert.strictEqual(geometry.growthStep, 2 * MB);
+        // Omitted fields remain unchanged.
+        assert.strictEqual(geometry.sizeLower, MB);
+        assert.ok(geometry.mapSize >= 128 * MB);
+
+        assert.throws(() => db.transact(() => db.setGeometry({ sizeUpper: 256 * MB })));
+        assert.throws(() => db.setGeometry({ growthStep: -1 }), /Wrong growthStep; should be a non-negative number of bytes/);
+        assert.strictEqual(db.stats().geometry.sizeUpper, 128 * MB);
+    });
+});
\ No newline at end of file
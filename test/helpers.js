@@ -0,0 +1,30 @@
+'use strict';
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const MDBX = require('../lib/binding');
+
+// Creates empty database directory; it should be removed with removeDbPath() (withDb() does it).
+function tempDbPath(name) {
+    const dbPath = fs.mkdtempSync(path.join(os.tmpdir(), `node_mdbx_test_${name}_`));
+    return dbPath;
+}
+
+function removeDbPath(dbPath) {
+    fs.rmSync(dbPath, { recursive: true, force: true });
+}
+
+// Opens database at a fresh path, runs action(db, dbPath) and removes the database afterwards.
+async function withDb(name, options, action) {
+    const dbPath = tempDbPath(name);
+    const db = new MDBX({ path: dbPath, maxDbs: 8, ...options });
+    try {
+        return await action(db, dbPath);
+    } finally {
+        if (!db.closed)
+            db.close();
+        removeDbPath(dbPath);
+    };
+}
+
+module.exports = { MDBX, tempDbPath, removeDbPath, withDb };
\ No newline at end of file
@@ -0,0 +1,62 @@
+'use strict';
+const test = require('node:test');
+const assert = require('assert');
+const { withDb } = require('./helpers');
+
+const KEYS = ['a', 'b', 'c', 'd'];
+
+function scan(dbi) {
+    const result = [];
+    for (let key = dbi.first(); key !== undefined; key = dbi.next(key))
+        result.push(key);
+    return result;
+}
+
+test('interned keys are reused by repeated scans', async () => {
+    await withDb('intern', { valueMode: 'string' }, db => {
+        db.transact(txn => {
+            const dbi = txn.getDbi('items', { internKeys: 16 });
+            for (const key of KEYS)
+                dbi.put(key, key);
+        });
+        db.transact(txn => {
+            const dbi = txn.getDbi('items', { internKeys: 16 });
+            const before = dbi.internStats();
+            assert.deepStrictEqual(scan(dbi), KEYS);
+            const first = dbi.internStats();
+            assert.deepStrictEqual(scan(dbi), KEYS);
+            const second = dbi.internStats();
+            assert.strictEqual(first.misses - before.misses, KEYS.length);
+            assert.strictEqual(second.hits - first.hits, KEYS.length);
+            assert.strictEqual(second.misses, first.misses);
+            assert.strictEqual(second.size, KEYS.length);
+            assert.strictEqual(second.capacity, 16);
+        });
+    });
+});
+
+test('least recently used keys are evicted', async () => {
+    await withDb('intern', { valueMode: 'string' }, db => db.transact(txn => {
+        const dbi = txn.getDbi('items', { internKeys: 2 });
+        for (const key of KEYS)
+            dbi.put(key, key);
+        const before = dbi.internStats();
+        assert.deepStrictEqual(scan(dbi), KEYS);
+        const stats = dbi.internStats();
+        assert.strictEqual(stats.size, 2);
+        assert.strictEqual(stats.misses - before.misses, KEYS.length);
+        assert.ok(stats.evictions >= KEYS.length - 2);
+    }));
+});
+
+test('interning is disabled by default and in buffer keyMode', async () => {
+    await withDb('intern', {}, db => db.transact(txn => {
+        assert.strictEqual(txn.getDbi('items').internStats(), undefined);
+    }));
+    await withDb('intern', { keyMode: 'buffer' }, db => db.transact(txn => {
+        const dbi = txn.getDbi('items', { internKeys: 16 });
+        dbi.put(Buffer.from('a'), Buffer.from('b'));
+        assert.deepStrictEqual(dbi.first(), Buffer.from('a'));
+        assert.strictEqual(dbi.internStats(), undefined);
+    }));
+});
\ No newline at end of file
@@ -0,0 +1,68 @@
+'use strict';
+const test = require('node:test');
+const assert = require('assert');
+const { withDb } = require('./helpers');
+
+function assertHistogram(histogram, count) {
+    assert.strictEqual(histogram.count, count);
+    assert.ok(histogram.min <= histogram.p50);
+    assert.ok(histogram.p50 <= histogram.p90);
+    assert.ok(histogram.p90 <= histogram.p99);
+    assert.ok(histogram.p99 <= histogram.p999);
+    assert.ok(histogram.p999 <= histogram.max);
+    assert.ok(histogram.min <= histogram.mean && histogram.mean <= histogram.max);
+}
+
+test('latency histograms count sampled operations per dbi', async () => {
+    await withDb('latency', { valueMode: 'string', latencySampling: true }, db => {
+        db.transact(txn => {
+            const dbi = txn.getDbi('items');
+            for (let i = 0; i < 100; i++)
+                dbi.put(`key${i}`, `value${i}`);
+        });
+        db.transact(txn => {
+            const dbi = txn.getDbi('items');
+            for (let i = 0; i < 200; i++)
+                dbi.get(`key${i}`);
+            dbi.has('key0');
+        });
+
+        const latency = db.stats().latency;
+        assert.strictEqual(latency.sampling, 1);
+        const items = latency.dbis.items;
+        assertHistogram(items.put, 100);
+        assertHistogram(items.get, 200);
+        assertHistogram(items.has, 1);
+        assert.strictEqual(items.del, undefined);
+        assert.ok(latency.begin.count >= 2);
+        assertHistogram(latency.commit.whole, latency.commit.whole.count);
+    });
+});
+
+test('latency sampling measures each n-th operation', async () => {
+    await withDb('latency', { valueMode: 'string', latencySampling: 4 }, db => {
+        db.transact(txn => {
+            const dbi = txn.getDbi('items');
+            for (let i = 0; i < 100; i++)
+                dbi.get(`key${i}`);
+        });
+        const latency = db.stats().latency;
+        assert.strictEqual(latency.sampling, 4);
+        assert.strictEqual(latency.dbis.items.get.count, 25);
+    });
+});
+
+test('resetLatency clears histograms after the snapshot', async () => {
+    await withDb('latency', { valueMode: 'string', latencySampling: 1 }, db => {
+        db.transact(txn => txn.getDbi('items').put('key', 'value'));
+        assert.strictEqual(db.stats({ resetLatency: true }).latency.dbis.items.put.count, 1);
+
+        const latency = db.stats().latency;
+        assert.strictEqual(latency.dbis.items?.put, undefined);
+        assert.strictEqual(latency.commit.whole.count, 0);
+        assert.strictEqual(latency.begin.count, 0);
+    });
+    await withDb('latency', {}, db => {
+        assert.strictEqual(db.stats().latency, undefined);
+    });
+});
\ No newline at end of file
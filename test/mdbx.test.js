@@ -0,0 +1,122 @@
+'use strict';
+const test = require('node:test');
+const assert = require('assert');
+const childProcess = require('child_process');
+const fs = require('fs');
+const path = require('path');
+const stream = require('stream');
+const { once } = require('events');
+const { MDBX, tempDbPath, removeDbPath, withDb } = require('./helpers');
+
+test('close during a background operation keeps the database opened', async () => {
+    await withDb('mdbx', { valueMode: 'string' }, async db => {
+        db.transact(txn => txn.getDbi('').put('key', 'value'));
+        const synced = db.sync();
+        // Sync starts from the queue of async transactions.
+        await new Promise(setImmediate);
+        assert.throws(() => db.close(), /busy with a background operation/);
+        assert.strictEqual(db.closed, false);
+        await synced;
+        assert.strictEqual(db.transact(txn => txn.getDbi('').get('key')), 'value');
+        db.close();
+        assert.strictEqual(db.closed, true);
+    });
+});
+
+test('datafile is not swapped while another process uses the database', async () => {
+    await withDb('mdbx', { valueMode: 'string' }, async (db, dbPath) => {
+        db.transact(txn => txn.getDbi('').put('key', 'value'));
+
+        // Reader keeps its slot in the reader table until it exits.
+        const reader = childProcess.spawn(process.execPath, ['-e', `
+            const MDBX = require(${JSON.stringify(require.resolve('../lib/binding'))});
+            const db = new MDBX({ path: ${JSON.stringify(dbPath)}, maxDbs: 8 });
+            db.transact(txn => txn.getDbi('').get('key'));
+            console.log('ready');
+            process.stdin.on('end', () => db.close()).resume();
+        `], { stdio: ['pipe', 'pipe', 'inherit'] });
+        const exited = once(reader, 'exit');
+        try {
+            await once(reader.stdout, 'data');
+            await assert.rejects(db.compact({ swap: true }), /opened by another process/);
+        } finally {
+            reader.stdin.end();
+            await exited;
+        };
+
+        const report = await db.compact({ swap: true });
+        assert.strictEqual(report.swapped, true);
+        assert.strictEqual(db.transact(txn => txn.getDbi('').get('key')), 'value');
+    });
+});
+
+test('gcStats inside a write transaction reports GC table stats only', async () => {
+    await withDb('mdbx', { valueMode: 'string' }, async (db, dbPath) => {
+        // Overwrites retire pages into GC.
+        for (let i = 0; i < 10; i++)
+            db.transact(txn => txn.getDbi('').put('key', 'value'.repeat(1000 + i)));
+
+        const outside = db.gcStats();
+        assert.ok(outside.gcEntries > 0);
+        assert.ok(outside.freePages > 0);
+
+        const inside = db.transact(() => db.gcStats());
+        assert.strictEqual(inside.pageSize, outside.pageSize);
+        assert.ok(inside.gcEntries > 0);
+        assert.ok(inside.gcTreePages > 0);
+        for (const field of ['freePages', 'livePages', 'reclaimablePages', 'pinnedPages', 'lastTxnWithFreePages'])
+            assert.strictEqual(inside[field], undefined, field);
+
+        db.close();
+        const readOnly = new MDBX({ path: dbPath, readOnly: true });
+        try {
+            assert.strictEqual(readOnly.transact(() => readOnly.gcStats()).freePages, outside.freePages);
+        } finally {
+            readOnly.close();
+        };
+    });
+});
+
+test('backupStream copies reopen with the same data', async () => {
+    await withDb('mdbx', { valueMode: 'string' }, async db => {
+        db.transact(txn => {
+            const dbi = txn.getDbi('items');
+            for (let i = 0; i < 2000; i++)
+                dbi.put(`key${i}`, `value${i}`.repeat(20));
+        });
+        // Deleted records leave free pages for the compact copy to omit.
+        db.transact(txn => {
+            const dbi = txn.getDbi('items');
+            for (let i = 0; i < 2000; i += 2)
+                dbi.del(`key${i}`);
+        });
+
+        const sizes = {};
+        for (const compact of [false, true]) {
+            const backupPath = tempDbPath('backup');
+            try {
+                const file = path.join(backupPath, 'mdbx.dat');
+                await stream.promises.pipeline(db.backupStream({ compact }), fs.createWriteStream(file));
+                sizes[compact] = fs.statSync(file).size;
+
+                const copy = new MDBX({ path: backupPath, maxDbs: 8, valueMode: 'string', readOnly: true });
+                try {
+                    copy.transact(txn => {
+                        const dbi = txn.getDbi('items');
+                        let count = 0;
+                        for (let key = dbi.first(); key !== undefined; key = dbi.next(key))
+                            count++;
+                        assert.strictEqual(count, 1000);
+                        assert.strictEqual(dbi.get('key1'), 'value1'.repeat(20));
+                        assert.strictEqual(dbi.has('key0'), false);
+                    });
+                } finally {
+                    copy.close();
+                };
+            } finally {
+                removeDbPath(backupPath);
+            };
+        }
+        assert.ok(sizes[true] <= sizes[false]);
+    });
+});
\ No newline at end of file
@@ -0,0 +1,87 @@
+'use strict';
+const test = require('node:test');
+const assert = require('assert');
+const { MDBX, tempDbPath, removeDbPath, withDb } = require('./helpers');
+
+test('msgpack round trip', async () => {
+    const values = {
+        nil: null,
+        undef: undefined,
+        flags: [true, false],
+        integers: [0, 1, -1, 127, 128, -32, -33, 255, 65535, 65536, -2147483648, 2 ** 32, Number.MAX_SAFE_INTEGER, -Number.MAX_SAFE_INTEGER],
+        floats: [0.5, -1.25, 1e300, Number.MIN_VALUE, Infinity, -Infinity],
+        strings: ['', 'a', 'юникод', 'x'.repeat(40), 'y'.repeat(300), 'z'.repeat(70000)],
+        buffer: Buffer.from([0, 1, 2, 0xc1, 255]),
+        date: new Date(1700000000123),
+        bigints: [2n ** 63n - 1n, -(2n ** 63n), 2n ** 64n - 1n],
+        nested: { a: [1, { b: 'c' }], d: {}, e: [] },
+        large: Array.from({ length: 100 }, (_, i) => ({ id: i, name: `item ${i}` })),
+    };
+    await withDb('msgpack', { valueMode: 'msgpack' }, db => {
+        db.transact(txn => {
+            const dbi = txn.getDbi('values');
+            for (const [key, value] of Object.entries(values))
+                dbi.put(key, value);
+        });
+        db.transact(txn => {
+            const dbi = txn.getDbi('values');
+            for (const [key, value] of Object.entries(values))
+                assert.deepStrictEqual(dbi.get(key), value, key);
+            assert.strictEqual(dbi.has('undef'), true);
+            // Integers are stored the same way, so safe ones are read as numbers.
+            dbi.put('smallBigInts', [0n, -1n, 2n ** 53n - 1n]);
+            assert.deepStrictEqual(dbi.get('smallBigInts'), [0, -1, Number.MAX_SAFE_INTEGER]);
+            assert.strictEqual(dbi.get('absent'), undefined);
+        });
+    });
+});
+
+test('msgpack rejects unsupported values', async () => {
+    await withDb('msgpack', { valueMode: 'msgpack' }, db => db.transact(txn => {
+        const dbi = txn.getDbi('values');
+        assert.throws(() => dbi.put('function', () => 1), /Unsupported value type/);
+        assert.throws(() => dbi.put('symbol', Symbol('s')), /Unsupported value type/);
+        assert.throws(() => dbi.put('bigint', 2n ** 64n), /out of 64-bit range/);
+        assert.throws(() => dbi.put('date', new Date(NaN)), /Invalid Date/);
+        const deep = [];
+        let level = deep;
+        for (let i = 0; i < 10000; i++)
+            level = level[0] = [];
+        assert.throws(() => dbi.put('deep', deep), /too deep/);
+        assert.strictEqual(dbi.has('function'), false);
+    }));
+});
+
+test('msgpack rejects malformed stored values', () => {
+    const malformed = {
+        neverUsed: [0xc1],
+        truncatedArray: [0x92, 0x01],
+        truncatedString: [0xa5, 0x61, 0x62],
+        missingLength: [0xd9],
+        truncatedFloat: [0xcb, 0, 0, 0],
+        trailingBytes: [0x01, 0x02],
+    };
+    const dbPath = tempDbPath('msgpack');
+    try {
+        let db = new MDBX({ path: dbPath, maxDbs: 2 });
+        db.transact(txn => {
+            const dbi = txn.getDbi('values');
+            for (const [key, bytes] of Object.entries(malformed))
+                dbi.put(key, Buffer.from(bytes));
+        });
+        db.close();
+
+        db = new MDBX({ path: dbPath, maxDbs: 2, valueMode: 'msgpack' });
+        try {
+            db.transact(txn => {
+                const dbi = txn.getDbi('values');
+                for (const key of Object.keys(malformed))
+                    assert.throws(() => dbi.get(key), /Malformed msgpack value/, key);
+            });
+        } finally {
+            db.close();
+        };
+    } finally {
+        removeDbPath(dbPath);
+    };
+});
\ No newline at end of file
@@ -0,0 +1,64 @@
+'use strict';
+const test = require('node:test');
+const assert = require('assert');
+const { MDBX, tempDbPath, removeDbPath } = require('./helpers');
+
+async function withOpened(options, action) {
+    const dbPath = tempDbPath('open');
+    try {
+        const db = await MDBX.open({ path: dbPath, maxDbs: 8, ...options });
+        try {
+            return await action(db, dbPath);
+        } finally {
+            db.close();
+        };
+    } finally {
+        removeDbPath(dbPath);
+    };
+}
+
+test('open creates dbis of options at startup', async () => {
+    const dbis = ['plain', { name: 'names', valueMode: 'string', comparator: 'lengthFirst' }];
+    await withOpened({ dbis }, db => {
+        db.transact(txn => {
+            txn.getDbi('plain').put('key', Buffer.from('value'));
+            const names = txn.getDbi('names');
+            for (const key of ['ccc', 'a', 'bb'])
+                names.put(key, key.toUpperCase());
+        });
+        db.transact(txn => {
+            assert.deepStrictEqual(txn.getDbi('plain').get('key'), Buffer.from('value'));
+            const names = txn.getDbi('names', { valueMode: 'string', comparator: 'lengthFirst' });
+            assert.strictEqual(names.first(), 'a');
+            assert.strictEqual(names.next('a'), 'bb');
+            assert.strictEqual(names.get('ccc'), 'CCC');
+            assert.throws(() => txn.getDbi('names', { valueMode: 'buffer' }), /different parameters/);
+            assert.throws(() => txn.getDbi('names', { valueMode: 'string' }), /different parameters/);
+        });
+    });
+});
+
+test('open of existing database reopens recorded dbis', async () => {
+    const dbPath = tempDbPath('open');
+    try {
+        const dbis = [{ name: 'names', valueMode: 'string', comparator: 'lengthFirst' }];
+        const created = await MDBX.open({ path: dbPath, maxDbs: 8, dbis });
+        created.transact(txn => txn.getDbi('names').put('bb', 'value'));
+        created.close();
+
+        const reopened = await MDBX.open({ path: dbPath, maxDbs: 8, readOnly: true, dbis });
+        try {
+            assert.strictEqual(reopened.transact(txn => txn.getDbi('names').get('bb')), 'value');
+        } finally {
+            reopened.close();
+        };
+    } finally {
+        removeDbPath(dbPath);
+    };
+});
+
+test('open rejects wrong dbis', async () => {
+    await assert.rejects(withOpened({ dbis: 'names' }, () => {}), /Wrong dbis; should be an array/);
+    await assert.rejects(withOpened({ dbis: [42] }, () => {}), /Wrong dbis item/);
+    await assert.rejects(withOpened({ dbis: [{ name: 'names', valueMode: 'xml' }] }, () => {}), /Wrong valueMode/);
+});
\ No newline at end of file
@@ -0,0 +1,31 @@
+'use strict';
+const test = require('node:test');
+const assert = require('assert');
+const { withDb } = require('./helpers');
+
+test('fixed point options take plain units', async () => {
+    await withDb('options', { mergeThresholdPercent: 25, syncPeriodMs: 1000 }, db => {
+        assert.strictEqual(db.getOption('mergeThresholdPercent'), 25);
+        assert.strictEqual(db.getOption('syncPeriodMs'), 1000);
+        db.setOption('mergeThresholdPercent', 37.5);
+        assert.strictEqual(db.getOption('mergeThresholdPercent'), 37.5);
+        db.setOption('syncPeriodMs', 250);
+        assert.ok(Math.abs(db.getOption('syncPeriodMs') - 250) < 0.1);
+    });
+});
+
+test('plain options are passed as is', async () => {
+    await withDb('options', { txnDpLimit: 12345 }, db => {
+        assert.strictEqual(db.getOption('txnDpLimit'), 12345);
+        db.setOption('syncBytes', 65536);
+        assert.strictEqual(db.getOption('syncBytes'), 65536);
+    });
+});
+
+test('unknown and wrong options are rejected', async () => {
+    await withDb('options', {}, db => {
+        assert.throws(() => db.getOption('syncPeriod16dot16'), /Wrong option name; should be one of: .*'syncPeriodMs'/);
+        assert.throws(() => db.setOption('noSuchOption', 1), /Wrong option name/);
+        assert.throws(() => db.setOption('syncBytes', -1), /Wrong syncBytes; should be a non-negative number/);
+    });
+});
\ No newline at end of file
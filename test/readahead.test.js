@@ -0,0 +1,44 @@
+'use strict';
+const test = require('node:test');
+const assert = require('assert');
+const { withDb } = require('./helpers');
+
+const MB = 1024 * 1024;
+
+test('readahead auto mode reports its check and repeats it on growth', async () => {
+    await withDb('readahead', { readahead: 'auto', sizeLower: MB, sizeNow: MB, growthStep: MB }, db => {
+        const before = db.stats().readahead;
+        assert.strictEqual(before.mode, 'auto');
+        // Small database always fits into RAM.
+        assert.strictEqual(before.reasonable, true);
+        assert.strictEqual(before.enabled, true);
+        assert.strictEqual(before.checkedSize, MB);
+        assert.match(before.reason, /database size 1MB fits into available RAM/);
+
+        db.transact(txn => {
+            const dbi = txn.getDbi('items');
+            for (let i = 0; i < 3000; i++)
+                dbi.put(`key${i}`, Buffer.alloc(1000));
+        });
+        const after = db.stats();
+        assert.strictEqual(after.readahead.checkedSize, after.geometry.sizeNow);
+        assert.ok(after.readahead.checkedSize > MB);
+    });
+});
+
+test('readahead on and off modes are reported as set', async () => {
+    await withDb('readahead', {}, db => {
+        const readahead = db.stats().readahead;
+        assert.strictEqual(readahead.mode, 'on');
+        assert.strictEqual(readahead.enabled, true);
+        assert.strictEqual(readahead.reason, 'enabled by option');
+    });
+    await withDb('readahead', { readahead: false }, db => {
+        const readahead = db.stats().readahead;
+        assert.strictEqual(readahead.mode, 'off');
+        assert.strictEqual(readahead.enabled, false);
+        assert.strictEqual(readahead.reason, 'disabled by option');
+    });
+    await assert.rejects(withDb('readahead', { readahead: 'sometimes' }, () => {}),
+        /Wrong readahead; should be true, false or 'auto'/);
+});
\ No newline at end of file
@@ -0,0 +1,71 @@
+'use strict';
+const test = require('node:test');
+const assert = require('assert');
+const { withDb } = require('./helpers');
+
+test('reserved buffer is detached when another dbi applies its buffered writes', async () => {
+    await withDb('reserve', {}, db => {
+        db.transact(txn => {
+            txn.getDbi('reserved');
+            txn.getDbi('buffered');
+        });
+        db.transact(txn => {
+            const reserved = txn.getDbi('reserved');
+            const buffered = txn.getDbi('buffered');
+            buffered.put('key', 'value');
+            const buffer = reserved.putReserve('key', 16);
+            assert.strictEqual(buffer.length, 16);
+            buffer.fill(1);
+            // Read method applies buffered writes of its dbi, which may move the reserved page space.
+            assert.strictEqual(buffered.first(), 'key');
+            assert.strictEqual(buffer.length, 0);
+        }, { writeBufferBytes: 1024 * 1024 });
+        db.transact(txn => assert.deepStrictEqual(txn.getDbi('reserved').get('key'), Buffer.alloc(16, 1)));
+    });
+});
+
+test('reserved buffer is filled in place and detached by the next write', async () => {
+    await withDb('reserve', {}, db => {
+        db.transact(txn => {
+            const dbi = txn.getDbi('items');
+            const buffer = dbi.putReserve('key', 5000);
+            assert.strictEqual(buffer.length, 5000);
+            buffer.fill('x');
+            dbi.put('other', 'value');
+            assert.strictEqual(buffer.length, 0);
+            // Writes into the detached buffer go nowhere.
+            buffer.fill('y');
+            assert.deepStrictEqual(dbi.get('key'), Buffer.alloc(5000, 'x'));
+        });
+        db.transact(txn => assert.deepStrictEqual(txn.getDbi('items').get('key'), Buffer.alloc(5000, 'x')));
+    });
+});
+
+test('reserved buffer is detached at the end of the transaction', async () => {
+    await withDb('reserve', {}, db => {
+        let buffer;
+        db.transact(txn => {
+            buffer = txn.getDbi('items').putReserve('key', 16);
+            buffer.fill(7);
+        });
+        assert.strictEqual(buffer.length, 0);
+        assert.throws(() => db.transact(txn => {
+            buffer = txn.getDbi('items').putReserve('aborted', 16);
+            throw new Error('abort');
+        }), /abort/);
+        assert.strictEqual(buffer.length, 0);
+        db.transact(txn => {
+            const dbi = txn.getDbi('items');
+            assert.deepStrictEqual(dbi.get('key'), Buffer.alloc(16, 7));
+            assert.strictEqual(dbi.get('aborted'), undefined);
+        });
+    });
+});
+
+test('putReserve rejects msgpack and compressed dbis and wrong sizes', async () => {
+    await withDb('reserve', {}, db => db.transact(txn => {
+        assert.throws(() => txn.getDbi('objects', { valueMode: 'msgpack' }).putReserve('key', 1), /not supported/);
+        assert.throws(() => txn.getDbi('compressed', { compression: 'lz4' }).putReserve('key', 1), /not supported/);
+        assert.throws(() => txn.getDbi('items').putReserve('key', -1), /Wrong size/);
+    }));
+});
\ No newline at end of file
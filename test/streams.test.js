@@ -0,0 +1,71 @@
+'use strict';
+const test = require('node:test');
+const assert = require('assert');
+const crypto = require('crypto');
+const { Readable } = require('stream');
+const { pipeline } = require('stream/promises');
+const { withDb } = require('./helpers');
+
+async function readAll(stream) {
+    const chunks = [];
+    for await (const chunk of stream)
+        chunks.push(chunk);
+    return Buffer.concat(chunks);
+}
+
+function chunksOf(buffer, size) {
+    const result = [];
+    for (let offset = 0; offset < buffer.length; offset += size)
+        result.push(buffer.subarray(offset, offset + size));
+    return result;
+}
+
+test('large value round trip through streams', async () => {
+    const value = crypto.randomBytes(300000);
+    await withDb('streams', {}, async db => {
+        await db.asyncTransact(async txn => {
+            const dbi = txn.getDbi('blobs');
+            await pipeline(Readable.from(chunksOf(value, 7000)), dbi.createWriteStream('blob', value.length));
+        });
+        await db.asyncTransact(async txn => {
+            const dbi = txn.getDbi('blobs');
+            assert.ok(dbi.get('blob').equals(value));
+            // Chunk size dividing the value exactly ends the stream with an empty slice.
+            for (const chunkSize of [4096, 100000, 1000000])
+                assert.ok((await readAll(dbi.createReadStream('blob', { chunkSize }))).equals(value), String(chunkSize));
+            assert.strictEqual((await readAll(dbi.createReadStream('blob', { chunkSize: 1000 }))).length, value.length);
+        });
+    });
+});
+
+test('read stream fails for missing key and after the transaction', async () => {
+    await withDb('streams', {}, async db => {
+        db.transact(txn => txn.getDbi('blobs').put('blob', Buffer.alloc(10000, 1)));
+        await db.asyncTransact(async txn => {
+            await assert.rejects(readAll(txn.getDbi('blobs').createReadStream('absent')), /Key not found/);
+        });
+        const stream = db.transact(txn => txn.getDbi('blobs').createReadStream('blob', { chunkSize: 1000 }));
+        await assert.rejects(readAll(stream), /Stale transaction/);
+        assert.throws(() => db.transact(txn => txn.getDbi('blobs').createReadStream('blob', { chunkSize: 0 })),
+            /Wrong chunkSize/);
+    });
+});
+
+test('write stream checks its size and is invalidated by other writes', async () => {
+    await withDb('streams', {}, async db => {
+        await db.asyncTransact(async txn => {
+            const dbi = txn.getDbi('blobs');
+            await assert.rejects(pipeline(Readable.from([Buffer.alloc(10)]), dbi.createWriteStream('short', 20)),
+                /Data is shorter than reserved size/);
+            await assert.rejects(pipeline(Readable.from([Buffer.alloc(30)]), dbi.createWriteStream('long', 20)),
+                /Data exceeds reserved size/);
+
+            const stream = dbi.createWriteStream('invalidated', 20);
+            dbi.put('other', 'value');
+            await assert.rejects(pipeline(Readable.from([Buffer.alloc(20)]), stream),
+                /Reserved value has been invalidated by another write/);
+        });
+        const stream = db.transact(txn => txn.getDbi('blobs').createWriteStream('stale', 20));
+        await assert.rejects(pipeline(Readable.from([Buffer.alloc(20)]), stream), /Stale transaction/);
+    });
+});
\ No newline at end of file
@@ -0,0 +1,52 @@
+'use strict';
+const test = require('node:test');
+const assert = require('assert');
+const { setTimeout: sleep } = require('timers/promises');
+const { withDb } = require('./helpers');
+
+function write(db, count) {
+    db.transact(txn => {
+        const dbi = txn.getDbi('items');
+        for (let i = 0; i < count; i++)
+            dbi.put(`key${i}`, Buffer.alloc(100, i));
+    });
+}
+
+test('sync flushes committed data', async () => {
+    await withDb('sync', { syncMode: 'safeNoSync' }, async db => {
+        write(db, 100);
+        const unsynced = db.stats().sync.unsyncedBytes;
+        assert.ok(unsynced > 0);
+        assert.strictEqual(await db.sync(), true);
+        // MDBX may still count a meta page as unsynced after the flush.
+        assert.ok(db.stats().sync.unsyncedBytes < unsynced);
+        assert.strictEqual(await db.sync(), false);
+    });
+});
+
+test('periodic sync flushes in background and counts flushes', async () => {
+    await withDb('sync', { syncMode: 'safeNoSync', syncInterval: 20 }, async db => {
+        write(db, 100);
+        const unsynced = db.stats().sync.unsyncedBytes;
+        for (let i = 0; i < 100 && db.stats().sync.synced === 0; i++)
+            await sleep(20);
+        const sync = db.stats().sync;
+        assert.ok(sync.synced > 0);
+        assert.ok(sync.unsyncedBytes < unsynced);
+        assert.strictEqual(sync.errors, 0);
+        assert.strictEqual(sync.interval, 20);
+
+        await sleep(100);
+        assert.ok(db.stats().sync.clean > 0);
+    });
+});
+
+test('periodic sync is not counted when disabled', async () => {
+    await withDb('sync', { syncMode: 'safeNoSync' }, async db => {
+        write(db, 10);
+        await sleep(50);
+        const sync = db.stats().sync;
+        assert.strictEqual(sync.synced + sync.clean + sync.busy + sync.errors, 0);
+        assert.ok(sync.unsyncedBytes > 0);
+    });
+});
\ No newline at end of file
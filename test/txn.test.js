@@ -0,0 +1,170 @@
+'use strict';
+const test = require('node:test');
+const assert = require('assert');
+const { withDb } = require('./helpers');
+
+const BUFFERED = { writeBufferBytes: 1024 * 1024 };
+
+// Creates dbi 'values' with given records in a separate transaction (so that later ones start clean).
+function prepare(db, records = {}) {
+    db.transact(txn => {
+        const dbi = txn.getDbi('values');
+        for (const key of Object.keys(records))
+            dbi.put(key, records[key]);
+    });
+}
+
+function entries(db) {
+    return db.transact(txn => {
+        const dbi = txn.getDbi('values');
+        const result = {};
+        for (let key = dbi.first(); key !== undefined; key = dbi.next(key))
+            result[key] = dbi.get(key);
+        return result;
+    });
+}
+
+const withStrings = (action) => withDb('txn', { valueMode: 'string' }, action);
+
+test('buffered writes are visible to reads of the transaction', async () => {
+    await withStrings(db => {
+        prepare(db, { stored: 'old', removed: 'old' });
+        db.transact(txn => {
+            const dbi = txn.getDbi('values');
+            dbi.put('stored', 'new');
+            dbi.put('added', 'new');
+            dbi.del('removed');
+            assert.strictEqual(txn.dirtyBytes(), 0);
+            assert.strictEqual(dbi.get('stored'), 'new');
+            assert.strictEqual(dbi.get('added'), 'new');
+            assert.strictEqual(dbi.has('added'), true);
+            assert.strictEqual(dbi.get('removed'), undefined);
+            assert.strictEqual(dbi.has('removed'), false);
+
+            dbi.put('temporary', 'value');
+            dbi.del('temporary');
+            assert.strictEqual(dbi.get('temporary'), undefined);
+            dbi.del('added');
+            dbi.put('added', 'again');
+            assert.strictEqual(dbi.get('added'), 'again');
+            // Reads are served by the buffer without applying it.
+            assert.strictEqual(txn.dirtyBytes(), 0);
+        }, BUFFERED);
+        assert.deepStrictEqual(entries(db), { added: 'again', stored: 'new' });
+    });
+});
+
+test('buffered writes are applied before navigation, range and reserve operations', async () => {
+    await withStrings(db => {
+        prepare(db, { b: 'stored', d: 'stored' });
+        db.transact(txn => {
+            const dbi = txn.getDbi('values');
+            dbi.put('a', 'buffered');
+            dbi.del('b');
+            assert.strictEqual(txn.dirtyBytes(), 0);
+            assert.strictEqual(dbi.first(), 'a');
+            assert.strictEqual(dbi.next('a'), 'd');
+            assert.ok(txn.dirtyBytes() > 0);
+
+            dbi.put('c', 'buffered');
+            dbi.put('e', 'buffered');
+            assert.strictEqual(dbi.delRange({ gte: 'b', lt: 'e' }), 2);
+            assert.strictEqual(dbi.get('e'), 'buffered');
+
+            dbi.put('r', 'buffered');
+            dbi.putReserve('r', 8).write('reserved');
+        }, BUFFERED);
+        assert.deepStrictEqual(entries(db), { a: 'buffered', e: 'buffered', r: 'reserved' });
+    });
+});
+
+test('buffered writes belong to the transaction they were made in', async () => {
+    await withStrings(db => {
+        prepare(db);
+        db.transact(txn => {
+            const dbi = txn.getDbi('values');
+            dbi.put('outer', 'value');
+            assert.throws(() => db.transact(() => {
+                dbi.put('inner', 'value');
+                assert.strictEqual(dbi.get('outer'), 'value');
+                throw new Error('Nested failure.');
+            }), /Nested failure/);
+            assert.strictEqual(dbi.get('inner'), undefined);
+            db.transact(() => dbi.put('committed', 'value'));
+        }, BUFFERED);
+        assert.deepStrictEqual(entries(db), { committed: 'value', outer: 'value' });
+    });
+});
+
+test('full write buffer is applied before transaction is split', async () => {
+    await withStrings(db => {
+        prepare(db);
+        const value = 'v'.repeat(512);
+        const count = 1000;
+        assert.throws(() => db.transact(txn => {
+            const dbi = txn.getDbi('values');
+            for (let i = 0; i < count; i++)
+                dbi.put(String(i).padStart(4, '0'), value);
+            throw new Error('Import failure.');
+        }, { writeBufferBytes: 64 * 1024, autoSplitBytes: 64 * 1024 }), /Import failure/);
+
+        // Splits commit whole buffers, so the kept records are a prefix of the written ones.
+        const keys = Object.keys(entries(db));
+        assert.ok(keys.length > 0 && keys.length < count, String(keys.length));
+        assert.deepStrictEqual(keys, Array.from({ length: keys.length }, (_, i) => String(i).padStart(4, '0')));
+    });
+});
+
+test('rollbackTo discards changes made after the savepoint', async () => {
+    await withStrings(db => {
+        prepare(db);
+        db.transact(txn => {
+            const dbi = txn.getDbi('values');
+            dbi.put('before', 'value');
+            const first = txn.savepoint();
+            dbi.put('first', 'value');
+            const second = txn.savepoint();
+            dbi.put('second', 'value');
+
+            txn.rollbackTo(second);
+            assert.strictEqual(dbi.has('second'), false);
+            assert.strictEqual(dbi.has('first'), true);
+
+            // Savepoint remains valid after rollback.
+            dbi.put('second', 'again');
+            txn.rollbackTo(first);
+            assert.strictEqual(dbi.has('first'), false);
+            assert.strictEqual(dbi.has('second'), false);
+            assert.strictEqual(dbi.get('before'), 'value');
+            assert.throws(() => txn.rollbackTo(second), /Unknown savepoint/);
+
+            dbi.put('after', 'value');
+        }, BUFFERED);
+        assert.deepStrictEqual(entries(db), { after: 'value', before: 'value' });
+    });
+});
+
+test('released and remaining savepoints keep their changes', async () => {
+    await withStrings(db => {
+        prepare(db);
+        db.transact(txn => {
+            const dbi = txn.getDbi('values');
+            const released = txn.savepoint();
+            dbi.put('released', 'value');
+            txn.releaseSavepoint(released);
+            assert.throws(() => txn.rollbackTo(released), /Unknown savepoint/);
+
+            txn.savepoint();
+            dbi.put('remaining', 'value');
+            assert.throws(() => db.transact(() => txn.savepoint()), /Nested transaction is still active/);
+        });
+        assert.deepStrictEqual(entries(db), { released: 'value', remaining: 'value' });
+
+        assert.throws(() => db.transact(txn => {
+            txn.savepoint();
+            txn.getDbi('values').put('aborted', 'value');
+            throw new Error('Failure.');
+        }), /Failure/);
+        assert.strictEqual(entries(db).aborted, undefined);
+    });
+});
\ No newline at end of file
@@ -0,0 +1,42 @@
+'use strict';
+const test = require('node:test');
+const assert = require('assert');
+const { withDb } = require('./helpers');
+
+test('writeMap mode rejects savepoints and flattens nested transactions', async () => {
+    await withDb('write_map', { writeMap: true, valueMode: 'string' }, db => {
+        db.transact(txn => {
+            assert.throws(() => txn.savepoint(), /Savepoints are not supported in read-only and writeMap modes/);
+            const dbi = txn.getDbi('items');
+            dbi.put('outer', '1');
+            db.transact(nested => nested.getDbi('items').put('nested', '2'));
+            // Failed nested transaction can't be rolled back separately: its writes stay in the outer one.
+            assert.throws(() => db.transact(nested => {
+                nested.getDbi('items').put('failed', '3');
+                throw new Error('nested');
+            }), /nested/);
+            assert.strictEqual(dbi.get('failed'), '3');
+        });
+        db.transact(txn => {
+            const dbi = txn.getDbi('items');
+            assert.strictEqual(dbi.get('outer'), '1');
+            assert.strictEqual(dbi.get('nested'), '2');
+            assert.strictEqual(dbi.get('failed'), '3');
+        });
+    });
+});
+
+test('writeMap mode commits and aborts top-level transactions', async () => {
+    await withDb('write_map', { writeMap: true, valueMode: 'string' }, async db => {
+        assert.throws(() => db.transact(txn => {
+            txn.getDbi('items').put('aborted', '1');
+            throw new Error('abort');
+        }), /abort/);
+        await db.asyncTransact(async txn => txn.getDbi('items').put('async', '2'));
+        db.transact(txn => {
+            const dbi = txn.getDbi('items');
+            assert.strictEqual(dbi.get('aborted'), undefined);
+            assert.strictEqual(dbi.get('async'), '2');
+        });
+    });
+});
\ No newline at end of file